@@ -1,10 +1,46 @@
 #include "file_proc.h"
 
 #include <string.h>
+#include <fcntl.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
 #include <unistd.h>
 #include "util/dbg/debug.h"
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+//* Size of a single read() call when text is read from a stream.
+static const size_t STREAM_BLOCK_SIZE = 1 << 16;
+
+/**
+ * @brief Read the whole stream into a growing buffer.
+ * 
+ * @param fd stream descriptor
+ * @param text text file to fill
+ * @param error_code variable to use as errno
+ */
+static void read_stream(int fd, TextFile* text, int* error_code);
+
+/**
+ * @brief Append line view to the text file.
+ * 
+ * @param text text file
+ * @param start first character of the line
+ * @param end character after the last character of the line
+ * @param error_code variable to use as errno
+ */
+static void push_line(TextFile* text, const char* start, const char* end, int* error_code);
+
+/**
+ * @brief Find all line breaks in the text and fill its line array.
+ * 
+ * @param text text file with loaded content
+ * @param error_code variable to use as errno
+ */
+static void split_lines(TextFile* text, int* error_code);
+
 size_t flength(int fd) {
     struct stat buffer;
     fstat(fd, &buffer);
@@ -44,6 +80,122 @@ size_t parse_lines(FILE* file, char** *text, char* *buffer, int* error_code) {
     return line_count;
 }
 
+void TextFile_dtor(TextFile* text) {
+    if (text->mapped) munmap(text->content, text->size);
+    else if (text->content) free(text->content);
+    if (text->lines) free(text->lines);
+
+    text->content = NULL;
+    text->size = 0;
+    text->mapped = false;
+    text->lines = NULL;
+    text->line_count = 0;
+    text->line_capacity = 0;
+}
+
+void map_text(const char* file_name, TextFile* text, int* error_code) {
+    _LOG_FAIL_CHECK_(file_name, "error", ERROR_REPORTS, return, error_code, EFAULT);
+    _LOG_FAIL_CHECK_(text, "error", ERROR_REPORTS, return, error_code, EFAULT);
+
+    bool from_stdin = strcmp(file_name, "-") == 0;
+
+    int fd = from_stdin ? STDIN_FILENO : open(file_name, O_RDONLY);
+    _LOG_FAIL_CHECK_(fd != -1, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Failed to open file \"%s\".\n", file_name);
+        return;
+    }, error_code, ENOENT);
+
+    struct stat info = {};
+    fstat(fd, &info);
+
+    if (S_ISREG(info.st_mode) && info.st_size > 0) {
+        void* mapping = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (mapping != MAP_FAILED) {
+            madvise(mapping, (size_t)info.st_size, MADV_SEQUENTIAL);
+            text->content = (char*) mapping;
+            text->size = (size_t)info.st_size;
+            text->mapped = true;
+        }
+    }
+
+    if (!text->mapped) {
+        log_printf(STATUS_REPORTS, "status", "Reading \"%s\" as a stream.\n", file_name);
+        read_stream(fd, text, error_code);
+    }
+
+    if (!from_stdin) close(fd);
+
+    split_lines(text, error_code);
+}
+
+static void read_stream(int fd, TextFile* text, int* error_code) {
+    size_t capacity = 0;
+
+    while (true) {
+        if (text->size + STREAM_BLOCK_SIZE > capacity) {
+            capacity = capacity ? capacity * 2 : STREAM_BLOCK_SIZE;
+
+            char* new_content = (char*) realloc(text->content, capacity);
+            _LOG_FAIL_CHECK_(new_content, "error", ERROR_REPORTS, return, error_code, ENOMEM);
+            text->content = new_content;
+        }
+
+        ssize_t length = read(fd, text->content + text->size, STREAM_BLOCK_SIZE);
+        _LOG_FAIL_CHECK_(length >= 0, "error", ERROR_REPORTS, return, error_code, EIO);
+
+        if (length == 0) break;
+        text->size += (size_t)length;
+    }
+}
+
+static void push_line(TextFile* text, const char* start, const char* end, int* error_code) {
+    if (text->line_count == text->line_capacity) {
+        size_t new_capacity = text->line_capacity ? text->line_capacity * 2 : 1024;
+
+        TextLine* new_lines = (TextLine*) realloc(text->lines, new_capacity * sizeof(*new_lines));
+        _LOG_FAIL_CHECK_(new_lines, "error", ERROR_REPORTS, return, error_code, ENOMEM);
+
+        text->lines = new_lines;
+        text->line_capacity = new_capacity;
+    }
+
+    text->lines[text->line_count].start = start;
+    text->lines[text->line_count].length = (size_t)(end - start);
+    ++text->line_count;
+}
+
+static void split_lines(TextFile* text, int* error_code) {
+    const char* ptr = text->content;
+    const char* end = text->content + text->size;
+    const char* line_start = ptr;
+
+#ifdef __SSE2__
+    const __m128i newline = _mm_set1_epi8('\n');
+
+    for (; ptr + sizeof(__m128i) <= end; ptr += sizeof(__m128i)) {
+        __m128i block = _mm_loadu_si128((const __m128i*)ptr);
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(block, newline));
+
+        while (mask) {
+            const char* line_end = ptr + __builtin_ctz(mask);
+            push_line(text, line_start, line_end, error_code);
+            line_start = line_end + 1;
+            mask &= mask - 1;
+        }
+    }
+#endif
+
+    for (; ptr < end; ++ptr) {
+        if (*ptr != '\n') continue;
+        push_line(text, line_start, ptr, error_code);
+        line_start = ptr + 1;
+    }
+
+    //* Text after the last line break is a line too (even if empty), just as in parse_lines().
+    push_line(text, line_start, end, error_code);
+}
+
 void fclose_var(FILE** file_var) {
     _LOG_FAIL_CHECK_(file_var, "error", ERROR_REPORTS, return, &errno, EFAULT);
     log_printf(STATUS_REPORTS, "status", "FClosing file %p.\n", *file_var);
@@ -15,6 +15,38 @@
 #include <cstdlib>
 #include <stdio.h>
 
+/**
+ * @brief View of a single line of text (not NUL-terminated).
+ * 
+ * @param start pointer to the first character of the line
+ * @param length number of characters in the line excluding the line break
+ */
+struct TextLine {
+    const char* start = NULL;
+    size_t length = 0;
+};
+
+/**
+ * @brief Text file loaded into memory and sliced into lines.
+ * 
+ * @param content text of the file
+ * @param size number of characters in the file
+ * @param mapped true if content is a memory mapping of the file, false if it was read into a buffer
+ * @param lines array of line views
+ * @param line_count number of lines
+ * @param line_capacity allocated size of the line array
+ */
+struct TextFile {
+    char* content = NULL;
+    size_t size = 0;
+    bool mapped = false;
+    TextLine* lines = NULL;
+    size_t line_count = 0;
+    size_t line_capacity = 0;
+};
+
+void TextFile_dtor(TextFile* text);
+
 /**
  * @brief Get length of the file.
  * 
@@ -34,6 +66,18 @@ size_t flength(int fd);
  */
 size_t parse_lines(FILE* file, char** *text, char* *buffer, int* error_code = NULL);
 
+/**
+ * @brief Map text file into memory and find its lines.
+ * 
+ * Regular files are mapped read-only, while pipes, terminals and "-" (standard input)
+ * are read as a stream. Lines reference the loaded text directly.
+ * 
+ * @param file_name name of the file to load ("-" for standard input)
+ * @param text text file to fill
+ * @param error_code variable to use as errno
+ */
+void map_text(const char* file_name, TextFile* text, int* error_code = NULL);
+
 /**
  * @brief Safely close and reset FILE* variable.
  * 
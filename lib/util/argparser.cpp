@@ -56,6 +56,11 @@ void edit_int(const int argc, void** argv, const char* argument) {
     *(int*)argv[0] = atoi(argument);
 }
 
+void enable_flag(const int argc, void** argv, const char* argument) {
+    UNUSE(argc); UNUSE(argument);
+    *(int*)argv[0] = 1;
+}
+
 void edit_string(const int argc, void** argv, const char* argument) {
     UNUSE(argc);
     strcpy(*(char**)argv, argument);
@@ -63,6 +63,15 @@ void parse_args(const int argc, const char** argv, const int actions_count, cons
  */
 void edit_int(const int argc, void** argv, const char* argument);
 
+/**
+ * @brief Set integer value (first pointer) to 1, argument is ignored.
+ * 
+ * @param argc number of arguments
+ * @param argv pointers to arguments (1-st element should be int*)
+ * @param argument argument as string
+ */
+void enable_flag(const int argc, void** argv, const char* argument);
+
 /**
  * @brief Set string value to the value of the argument.
  * 
@@ -2,11 +2,14 @@
 
 #include <string.h>
 #include <time.h>
+#include <pthread.h>
 
 #include "debug.h"
 
 static FILE* logfile = NULL;
 static unsigned int log_threshold = 0;
+//* Log lines can be printed from multiple threads (see assembler chunks).
+static pthread_mutex_t log_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 /**
  * @brief Prints out log line prefix (time and tag).
@@ -55,9 +58,11 @@ void _log_printf(const unsigned int importance, const char* tag, const char* for
     va_start(args, format);
 
     if (importance >= log_threshold && logfile) {
+        pthread_mutex_lock(&log_mutex);
         log_prefix(tag, importance);
         vfprintf(log_file(importance), format, args);
         fflush(log_file(importance));
+        pthread_mutex_unlock(&log_mutex);
     }
 
     va_end(args);
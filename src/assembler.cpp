@@ -16,6 +16,8 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <stdint.h>
+#include <time.h>
+#include <pthread.h>
 
 #include "lib/util/dbg/debug.h"
 #include "lib/util/argparser.h"
@@ -25,6 +27,14 @@
 #include "lib/alloc_tracker/alloc_tracker.h"
 #include "utils/common.h"
 #include "utils/argworks.h"
+#include "utils/labels.h"
+#include "utils/asm_cache.h"
+#include "utils/objfile.h"
+#include "utils/data_section.h"
+#include "utils/debug_info.h"
+#include "utils/binfile.h"
+#include "utils/packed_code.h"
+#include "utils/cmd_encoder.h"
 
 #define ASSEMBLER
 
@@ -37,94 +47,215 @@
 void print_label();
 
 /**
- * @brief Print binary header to the file.
+ * @brief Cross-module references of the code assembled into an object file.
  * 
- * @param output 
+ * @param exports hashes of labels declared with GLOBAL directive
+ * @param relocations ObjRelocation records of jump operands referring to labels the module does not declare
  */
-void put_header(FILE* output);
+struct LinkInfo {
+    PseudoFile exports = {};
+    PseudoFile relocations = {};
+};
 
-/**
- * @brief Binary buffer with its size.
- * 
- * @param content storage content of the p-file
- * @param size number of filled bytes
- */
-struct PseudoFile {
-    char* content = NULL;
-    size_t size = 0;
-} output_content;
+void LinkInfo_dtor(LinkInfo* info);
 
 /**
- * @brief JMP destination, marked in code with HERE word.
+ * @brief Source map of the code being assembled.
  * 
- * @param hash label name hash
- * @param point label jump dastination
- * @param name (unused) label name
+ * @param lines LineMapping of every instruction
+ * @param labels label records in source map format
+ * @param label_count number of label records
  */
-struct CodeLabel {
-    hash_t hash = 0;
-    uintptr_t point = 0;
-    const char* name = NULL;
+struct SourceMap {
+    PseudoFile lines = {};
+    PseudoFile labels = {};
+    size_t label_count = 0;
 };
 
+void SourceMap_dtor(SourceMap* map);
+
 /**
- * @brief Set of code labels.
+ * @brief Slice of the source text assembled by a single thread.
  * 
- * @param array list of labels
- * @param max_size max number of labels the set can store
+ * @param lines first line of the chunk
+ * @param line_count number of lines in the chunk
+ * @param first_line source line number of the first line of the chunk
+ * @param text_begin first line of the source file
+ * @param text_end line after the last line of the source file
+ * @param fuse true if constant pushes should be fused into the following commands
+ * @param labels labels the chunk reads from (and writes to on the first pass)
+ * @param code binary content of the chunk
+ * @param data data blocks of the chunk
+ * @param base offset of the chunk in the output binary
+ * @param listing in-memory listing of the chunk
+ * @param listing_size size of the listing
+ * @param final_pass true if labels are already resolved and should not be modified
+ * @param cache encodings from the previous build (NULL if caching is disabled)
+ * @param new_cache encodings produced by the chunk on the final pass
+ * @param cache_hits number of lines taken from the cache on the final pass
+ * @param encoder labels and position of the line being processed
+ * @param relocatable true if undefined labels should be recorded as relocations
+ * @param link exports and relocations of the chunk
+ * @param mapped true if source map should be collected
+ * @param map source map of the chunk
+ * @param err_code chunk error code
  */
-struct LabelSet {
-    CodeLabel* array = NULL;
-    size_t size = 0;
-    size_t max_size = 1024;
+struct AsmChunk {
+    const TextLine* lines = NULL;
+    size_t line_count = 0;
+    size_t first_line = 0;
+    const TextLine* text_begin = NULL;
+    const TextLine* text_end = NULL;
+    bool fuse = false;
+    LabelSet* labels = NULL;
+    PseudoFile code = {};
+    PseudoFile data = {};
+    size_t base = 0;
+    char* listing = NULL;
+    size_t listing_size = 0;
+    bool final_pass = false;
+    const AsmCache* cache = NULL;
+    AsmCache new_cache = {};
+    size_t cache_hits = 0;
+    CmdEncoder encoder = {};
+    bool relocatable = false;
+    LinkInfo link = {};
+    bool mapped = false;
+    SourceMap map = {};
+    int err_code = 0;
 };
 
-void LabelSet_ctor(LabelSet* set);
-
-void LabelSet_dtor(LabelSet* set);
+void AsmChunk_dtor(AsmChunk* chunk);
 
 /**
- * @brief Read all lines of text and write their interpretation to file.
+ * @brief Read all lines of text and write their interpretation to the buffer.
  * 
- * @param labels set of labels to modify
- * @param output file to write the result to
+ * Lines are split into chunks assembled on separate threads. The first pass collects chunk-local labels
+ * and chunk sizes, labels are then relocated by chunk offsets and merged, and the final pass encodes
+ * every chunk against the merged label table.
+ * 
+ * @param labels set of labels to fill
+ * @param output buffer to write the result to
+ * @param data buffer to write data blocks to
  * @param listing listing file
  * @param lines array of lines of text
  * @param line_count number of lines in text
+ * @param thread_count max number of threads to use (0 - number of online processors)
+ * @param cache encodings of the previous build, replaced with encodings of this one (NULL - no caching)
+ * @param link where to put exports and relocations (NULL - undefined labels are not recorded)
+ * @param map where to put the source map (NULL - do not collect)
+ * @param fuse true if constant pushes should be fused into the following commands (see fuse_lines())
+ * @param err_code variable to use as errno
+ */
+void assemble(LabelSet* labels, PseudoFile* output, PseudoFile* data, FILE* listing,
+              const TextLine* lines, size_t line_count, size_t thread_count,
+              AsmCache* cache = NULL, LinkInfo* link = NULL, SourceMap* map = NULL, bool fuse = true,
+              int* err_code = NULL);
+
+/**
+ * @brief Write assembled module as an object file.
+ * 
+ * @param output file to write to
+ * @param code module code
+ * @param data module data blocks
+ * @param labels module labels
+ * @param link module exports and relocations
  * @param err_code variable to use as errno
  */
-void assemble(LabelSet* labels, FILE* listing, char** lines, size_t line_count, int* err_code = NULL);
+void put_object(FILE* output, const PseudoFile* code, const PseudoFile* data, const LabelSet* labels,
+                const LinkInfo* link, int* const err_code = NULL);
+
+/**
+ * @brief Copy the line into NUL-terminated buffer.
+ * 
+ * @param line line to copy
+ * @param text buffer of MAX_LINE_LENGTH characters
+ * @param err_code variable to use as errno
+ * @return true if the line fits into the buffer
+ */
+bool copy_line(const TextLine* line, char* text, int* const err_code = NULL);
+
+/**
+ * @brief Assemble chunks in parallel and wait for all of them to finish.
+ * 
+ * @param chunks array of chunks
+ * @param chunk_count number of chunks
+ */
+void run_chunks(AsmChunk* chunks, size_t chunk_count);
+
+/**
+ * @brief Assemble all lines of the chunk (thread routine).
+ * 
+ * @param chunk chunk to assemble
+ * @return NULL
+ */
+void* assemble_chunk(void* chunk);
 
 /**
- * @brief Read one line of text and put it into binary file.
+ * @brief Read one line of text and put it into chunk binary.
  * 
- * @param labels set of labels to modify
+ * @param chunk chunk to write the line to
  * @param line command to process
- * @param output output binary file
  * @param listing output listing file
  * @param err_code variable to use as errno
  */
-void process_line(LabelSet* labels, const char* line, FILE* listing = NULL, int* const err_code = NULL);
+void process_line(AsmChunk* chunk, const TextLine* line, FILE* listing = NULL, int* const err_code = NULL);
 
 /**
- * @brief Add label to label table.
+ * @brief Check if the line pushes a constant that is immediately used by the next line.
  * 
- * @param labels set of labels to add the label to
- * @param hash label name hash
- * @param point label value
+ * PUSH c followed by ADD, SUB, MUL, DIV or a conditional jump is replaced with a single command
+ * with an immediate operand (ADDI c, JMPGI c label, ...) that does exactly the same.
+ * Empty and comment lines between them are skipped, the next command line is then consumed
+ * by the fused command and produces no code.
+ * 
+ * @param chunk chunk the line belongs to
+ * @param line line to check
+ * @param text buffer of MAX_LINE_LENGTH characters to put the fused command into
+ * @return true if the lines can be fused
+ */
+bool fuse_lines(const AsmChunk* chunk, const TextLine* line, char* text);
+
+/**
+ * @brief Find the closest line with a command in the given direction, skipping empty and comment lines.
+ * 
+ * @param chunk chunk the line belongs to
+ * @param line line to start the search from (not included)
+ * @param step 1 to search forwards, -1 to search backwards
+ * @return const TextLine* line with a command (or NULL if there is none)
+ */
+const TextLine* command_line_near(const AsmChunk* chunk, const TextLine* line, int step);
+
+/**
+ * @brief Find the next whitespace-separated word of the line.
+ * 
+ * @param ptr position to start the search from
+ * @param end end of the line
+ * @param word_end where to put the pointer to the character after the word
+ * @return const char* first character of the word (or end if there are no words left)
+ */
+const char* next_word(const char* ptr, const char* end, const char** word_end);
+
+/**
+ * @brief Record label operands of the line being processed that refer to other modules.
+ * 
+ * Label operand is always the last operand of an instruction.
+ * 
+ * @param chunk chunk the line belongs to
+ * @param cmd_size size of the line encoding
  * @param err_code variable to use as errno
  */
-void add_label(LabelSet* labels, hash_t hash, uintptr_t point, int* const err_code = NULL);
+void record_relocations(AsmChunk* chunk, size_t cmd_size, int* const err_code = NULL);
 
 /**
- * @brief Get the label object from label name hash.
+ * @brief Put label at the current position into the chunk source map.
  * 
- * @param labels set of labels to get the label from
- * @param hash label name hash
+ * @param chunk chunk the label belongs to
+ * @param name first character of the label name
+ * @param name_end character after the label name
  * @param err_code variable to use as errno
- * @return uintptr_t 
  */
-uintptr_t get_label(LabelSet* labels, hash_t hash, int* const err_code = NULL);
+void map_label(AsmChunk* chunk, const char* name, const char* name_end, int* const err_code = NULL);
 
 int main(const int argc, const char** argv) {
     atexit(log_end_program);
@@ -137,6 +268,21 @@ int main(const int argc, const char** argv) {
     //* Output file size.
     static size_t out_size = 0xFFFF;
     static char listing_name[1024] = DEFAULT_LISTING_NAME;
+    //* Number of assembly threads (0 - number of online processors).
+    static int thread_count = 0;
+    //* Incremental reassembly cache file ("" - do not cache).
+    static char cache_name[1024] = "";
+    static AsmCache cache = {};
+    //* Produce object file instead of a binary.
+    static int gen_object = 0;
+    static LinkInfo link = {};
+    //* Source map file name ("" - do not write source map).
+    static char map_name[1024] = "";
+    static SourceMap map = {};
+    //* Write code in the dense form.
+    static int pack = 0;
+    //* Do not replace constant pushes with commands with immediate operands.
+    static int no_fuse = 0;
 
     ActionTag line_tags[] = {
         #include "cmd_flags/assembler_flags.h"
@@ -152,10 +298,11 @@ int main(const int argc, const char** argv) {
 
     track_allocation(&labels, (dtor_t*)LabelSet_dtor);
 
-    output_content.content = (char*) calloc(out_size, sizeof(char));
-    _LOG_FAIL_CHECK_(output_content.content, "error", ERROR_REPORTS, return EXIT_FAILURE, &errno, ENOMEM);
+    static PseudoFile output_content = {};
+    track_allocation(&output_content, (dtor_t*)PseudoFile_dtor);
 
-    track_allocation(&output_content, (dtor_t*)LabelSet_dtor);
+    static PseudoFile data_content = {};
+    track_allocation(&data_content, (dtor_t*)PseudoFile_dtor);
 
     const char* file_name = get_input_file_name(argc, argv);
     _LOG_FAIL_CHECK_(file_name, "error", ERROR_REPORTS, {
@@ -168,29 +315,23 @@ int main(const int argc, const char** argv) {
 
     const char* out_name = get_output_file_name(argc, argv);
     if (out_name == NULL) {
-        out_name = DEFAULT_BINARY_OUT_NAME;
+        out_name = gen_object ? DEFAULT_OBJECT_OUT_NAME : DEFAULT_BINARY_OUT_NAME;
     }
 
-    log_printf(STATUS_REPORTS, "status", "Opening input file %s.\n", file_name);
-    //* We need bufferization for windows capability (sigh...)
-    FILE* input = fopen(file_name, "r");
-    _LOG_FAIL_CHECK_(input, "error", ERROR_REPORTS, {
-        log_printf(ERROR_REPORTS, "error", "Failed to open input file \"%s\", terminating...\n", file_name);
+    log_printf(STATUS_REPORTS, "status", "Loading input file %s.\n", file_name);
+    static TextFile source = {};
+    track_allocation(&source, (dtor_t*)TextFile_dtor);
+
+    map_text(file_name, &source, &errno);
+    _LOG_FAIL_CHECK_(source.lines, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Failed to load input file \"%s\", terminating...\n", file_name);
         
         return_clean(EXIT_FAILURE);
 
     }, NULL, 0);
-    setvbuf(input, NULL, _IOFBF, flength(fileno(input)));
-
-    char* buffer = NULL;
-    char** lines = NULL;
-    size_t line_count = parse_lines(input, &lines, &buffer, &errno);
 
-    log_printf(STATUS_REPORTS, "status", "LINES value is %p.\n", lines);
-    track_allocation(&lines, (dtor_t*)free_var);
-    track_allocation(&buffer, (dtor_t*)free_var);
-
-    fclose(input); input = NULL;
+    const TextLine* lines = source.lines;
+    size_t line_count = source.line_count;
 
     log_printf(STATUS_REPORTS, "status", "Opening output file %s.\n", out_name);
     FILE* output = fopen(out_name, "wb");
@@ -218,22 +359,98 @@ int main(const int argc, const char** argv) {
 
     } else log_printf(STATUS_REPORTS, "status", "Listing files were disabled.\n");
 
-    log_printf(STATUS_REPORTS, "status", "Entering first pass...\n");
+    log_printf(STATUS_REPORTS, "status", "Assembling %ld lines...\n", line_count);
 
-    assemble(&labels, listing, lines, line_count, &errno);
+    if (*cache_name) {
+        AsmCache_ctor(&cache);
+        track_allocation(&cache, (dtor_t*)AsmCache_dtor);
 
-    log_printf(STATUS_REPORTS, "status", "Entering final pass...\n");
-    log_printf(STATUS_REPORTS, "status", "Resetting listing file...\n");
-    fseek(listing, 0, SEEK_SET);
+        cache_load(&cache, cache_name, get_hash(BUILD_STAMP, BUILD_STAMP + sizeof(BUILD_STAMP)), &errno);
+    }
+
+    struct timespec asm_start = {}, asm_end = {};
+    clock_gettime(CLOCK_MONOTONIC, &asm_start);
+
+    if (gen_object) track_allocation(&link, (dtor_t*)LinkInfo_dtor);
+
+    if (*map_name && gen_object) {
+        log_printf(WARNINGS, "warning", "Source maps are not written for object files.\n");
+        *map_name = '\0';
+    }
+
+    if (*map_name) track_allocation(&map, (dtor_t*)SourceMap_dtor);
 
-    output_content.size = 0;
+    assemble(&labels, &output_content, &data_content, listing, lines, line_count, (size_t)thread_count,
+             *cache_name ? &cache : NULL, gen_object ? &link : NULL, *map_name ? &map : NULL, !no_fuse, &errno);
 
-    assemble(&labels, listing, lines, line_count, &errno);
+    clock_gettime(CLOCK_MONOTONIC, &asm_end);
+    printf("Assembled %lu lines in %.3lf ms.\n", line_count,
+           (double)(asm_end.tv_sec - asm_start.tv_sec) * 1e3 + (double)(asm_end.tv_nsec - asm_start.tv_nsec) / 1e6);
 
-    log_printf(STATUS_REPORTS, "status", "Writing header to the output file.\n");
-    put_header(output);
-    log_printf(STATUS_REPORTS, "status", "Writing content to the file.\n");
-    fwrite(output_content.content, sizeof(char), output_content.size, output);
+    _LOG_FAIL_CHECK_(output_content.size + data_content.size <= out_size, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Program size of %ld bytes exceeds the limit of %ld bytes, terminating.\n",
+                                           output_content.size + data_content.size, out_size);
+
+        return_clean(EXIT_FAILURE);
+
+    }, &errno, EFBIG);
+
+    //* Source map is written to its own file and embedded into the binary.
+    static char* map_content = NULL;
+    size_t map_size = 0;
+
+    if (*map_name && errno == 0) {
+        FILE* map_stream = open_memstream(&map_content, &map_size);
+        _LOG_FAIL_CHECK_(map_stream, "error", ERROR_REPORTS, return_clean(EXIT_FAILURE), &errno, ENOMEM);
+
+        write_debug_info(map_stream, file_name, (const LineMapping*) map.lines.content, map.lines.size / sizeof(LineMapping),
+                         map.labels.content, map.labels.size, map.label_count, &errno);
+        fclose(map_stream);
+        track_allocation(&map_content, (dtor_t*)free_var);
+
+        log_printf(STATUS_REPORTS, "status", "Writing source map to %s.\n", map_name);
+
+        FILE* map_file = fopen(map_name, "wb");
+        _LOG_FAIL_CHECK_(map_file, "warning", WARNINGS, {
+            log_printf(WARNINGS, "warning", "Failed to create source map file \"%s\".\n", map_name);
+        }, NULL, 0);
+
+        if (map_file) {
+            fwrite(map_content, sizeof(char), map_size, map_file);
+            fclose(map_file);
+        }
+    }
+
+    if (*cache_name && errno == 0) {
+        log_printf(STATUS_REPORTS, "status", "Saving cache to %s.\n", cache_name);
+        cache_save(&cache, cache_name, get_hash(BUILD_STAMP, BUILD_STAMP + sizeof(BUILD_STAMP)), &errno);
+    }
+
+    if (gen_object) {
+        log_printf(STATUS_REPORTS, "status", "Writing object file.\n");
+        put_object(output, &output_content, &data_content, &labels, &link, &errno);
+
+        return_clean(errno == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    static PseudoFile packed_content = {};
+    if (pack) {
+        track_allocation(&packed_content, (dtor_t*)PseudoFile_dtor);
+
+        pack_code(output_content.content, output_content.size, &packed_content, &errno);
+        _LOG_FAIL_CHECK_(errno == 0, "error", ERROR_REPORTS, return_clean(EXIT_FAILURE), NULL, 0);
+
+        printf("Packed %lu bytes of code into %lu bytes.\n", output_content.size, packed_content.size);
+    }
+
+    log_printf(STATUS_REPORTS, "status", "Writing binary to the output file.\n");
+    BinSection sections[] = {
+        pack ? (BinSection) { SECTION_PACKED, packed_content.content, packed_content.size }
+             : (BinSection) { SECTION_CODE,   output_content.content, output_content.size },
+        { SECTION_DATA,  data_content.content,   data_content.size   },
+        { SECTION_DEBUG, map_content,            map_size            },
+    };
+    write_binary(output, sections, sizeof(sections) / sizeof(*sections), &errno);
 
     return_clean(errno == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
 }
@@ -245,86 +462,393 @@ void print_label() {
     log_printf(ABSOLUTE_IMPORTANCE, "build info", "Build from %s %s.\n", __DATE__, __TIME__);
 }
 
-void put_header(FILE* output) {
-    _LOG_FAIL_CHECK_(output, "error", ERROR_REPORTS, return, NULL, 0);
-    fwrite(FILE_PREFIX, PREFIX_SIZE, 1, output);
-    fwrite(&PROC_VERSION, sizeof(PROC_VERSION), 1, output);
-    fseek(output, HEADER_SIZE, SEEK_SET);
+void LinkInfo_dtor(LinkInfo* info) {
+    PseudoFile_dtor(&info->exports);
+    PseudoFile_dtor(&info->relocations);
 }
 
+void put_object(FILE* output, const PseudoFile* code, const PseudoFile* data, const LabelSet* labels,
+                const LinkInfo* link, int* const err_code) {
+    _LOG_FAIL_CHECK_(output, "error", ERROR_REPORTS, return, err_code, EFAULT);
 
-void LabelSet_ctor(LabelSet* set) {
-    set->array = (CodeLabel*)calloc(set->max_size, sizeof(*set->array));
-    set->size = 0;
+    size_t symbol_count = link->exports.size / sizeof(hash_t);
+    ObjSymbol* symbols = (ObjSymbol*) calloc(symbol_count + 1, sizeof(*symbols));
+    _LOG_FAIL_CHECK_(symbols, "error", ERROR_REPORTS, return, err_code, ENOMEM);
+
+    for (size_t symbol_id = 0; symbol_id < symbol_count; ++symbol_id) {
+        memcpy(&symbols[symbol_id].hash, link->exports.content + symbol_id * sizeof(hash_t), sizeof(hash_t));
+
+        uintptr_t point = get_label(labels, symbols[symbol_id].hash);
+        _LOG_FAIL_CHECK_(point >= HEADER_SIZE, "error", ERROR_REPORTS, {
+            log_printf(ERROR_REPORTS, "error", "Label with hash %llX was exported but never declared.\n",
+                                               symbols[symbol_id].hash);
+            free(symbols);
+            return;
+        }, err_code, EINVAL);
+
+        symbols[symbol_id].point = (uint32_t)(point - HEADER_SIZE);
+    }
+
+    ObjectFile object = {};
+    object.code = code->content;
+    object.code_size = code->size;
+    object.data = data->content;
+    object.data_size = data->size;
+    object.symbols = symbols;
+    object.symbol_count = symbol_count;
+    object.relocations = (const ObjRelocation*) link->relocations.content;
+    object.relocation_count = link->relocations.size / sizeof(ObjRelocation);
+
+    log_printf(STATUS_REPORTS, "status", "Writing object with %lu exports and %lu relocations.\n",
+                                         object.symbol_count, object.relocation_count);
+
+    write_object(output, &object, err_code);
+
+    free(symbols);
 }
 
-void LabelSet_dtor(LabelSet* set) {
-    if (set->array) free(set->array);
-    set->array = NULL;
-    set->size = 0;
+void SourceMap_dtor(SourceMap* map) {
+    PseudoFile_dtor(&map->lines);
+    PseudoFile_dtor(&map->labels);
+    map->label_count = 0;
+}
+
+void AsmChunk_dtor(AsmChunk* chunk) {
+    PseudoFile_dtor(&chunk->code);
+    PseudoFile_dtor(&chunk->data);
+    LinkInfo_dtor(&chunk->link);
+    SourceMap_dtor(&chunk->map);
+    AsmCache_dtor(&chunk->new_cache);
+    if (chunk->listing) free(chunk->listing);
+    chunk->listing = NULL;
+    chunk->listing_size = 0;
+}
+
+void assemble(LabelSet* labels, PseudoFile* output, PseudoFile* data, FILE* listing,
+              const TextLine* lines, size_t line_count, size_t thread_count,
+              AsmCache* cache, LinkInfo* link, SourceMap* map, bool fuse, int* err_code) {
+    _LOG_FAIL_CHECK_(labels->array, "error", ERROR_REPORTS, return, err_code, ENOENT);
+
+    //* Collected separately as thread routines are allowed to change errno.
+    int status = 0;
+
+    if (thread_count == 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        thread_count = online > 0 ? (size_t)online : 1;
+    }
+
+    size_t chunk_count = (line_count + MIN_CHUNK_LINES - 1) / MIN_CHUNK_LINES;
+    if (chunk_count > thread_count) chunk_count = thread_count;
+    if (chunk_count > MAX_ASM_THREADS) chunk_count = MAX_ASM_THREADS;
+    if (chunk_count == 0) chunk_count = 1;
+
+    log_printf(STATUS_REPORTS, "status", "Splitting %ld lines into %ld chunks.\n", line_count, chunk_count);
+
+    AsmChunk* chunks = (AsmChunk*) calloc(chunk_count, sizeof(*chunks));
+    LabelSet* local_labels = (LabelSet*) calloc(chunk_count, sizeof(*local_labels));
+    _LOG_FAIL_CHECK_(chunks && local_labels, "error", ERROR_REPORTS, {
+        free(chunks);
+        free(local_labels);
+        return;
+    }, err_code, ENOMEM);
+
+    for (size_t chunk_id = 0; chunk_id < chunk_count; ++chunk_id) {
+        size_t first = line_count * chunk_id / chunk_count;
+        size_t last  = line_count * (chunk_id + 1) / chunk_count;
+
+        local_labels[chunk_id].max_size = labels->max_size;
+        LabelSet_ctor(&local_labels[chunk_id]);
+
+        chunks[chunk_id].lines = lines + first;
+        chunks[chunk_id].line_count = last - first;
+        chunks[chunk_id].first_line = first + 1;
+        chunks[chunk_id].text_begin = lines;
+        chunks[chunk_id].text_end = lines + line_count;
+        chunks[chunk_id].fuse = fuse;
+        chunks[chunk_id].labels = &local_labels[chunk_id];
+        chunks[chunk_id].cache = cache;
+        chunks[chunk_id].relocatable = link != NULL;
+        chunks[chunk_id].mapped = map != NULL;
+
+        _LOG_FAIL_CHECK_(local_labels[chunk_id].array, "error", ERROR_REPORTS, {
+            chunk_count = chunk_id + 1;
+            break;
+        }, &status, ENOMEM);
+    }
+
+    log_printf(STATUS_REPORTS, "status", "Entering first pass...\n");
+
+    run_chunks(chunks, chunk_count);
+
+    log_printf(STATUS_REPORTS, "status", "Relocating chunk labels...\n");
+
+    size_t offset = 0;
+    for (size_t chunk_id = 0; chunk_id < chunk_count; ++chunk_id) {
+        AsmChunk* chunk = &chunks[chunk_id];
+        chunk->base = offset;
+
+        for (size_t label_id = 0; label_id < chunk->labels->size; ++label_id) {
+            const CodeLabel* label = &chunk->labels->array[label_id];
+
+            if (get_label(labels, label->hash)) {
+                log_printf(WARNINGS, "warning", "Label with hash %llX was declared more than once, "
+                                                "the last declaration will be used.\n", label->hash);
+            }
+
+            add_label(labels, label->hash, label->point + offset, &status);
+        }
+
+        offset += chunk->code.size;
+        chunk->code.size = 0;
+        chunk->labels = labels;
+        chunk->final_pass = true;
+
+        if (cache) AsmCache_ctor(&chunk->new_cache);
+    }
+
+    log_printf(STATUS_REPORTS, "status", "Entering final pass...\n");
+
+    run_chunks(chunks, chunk_count);
+
+    log_printf(STATUS_REPORTS, "status", "Concatenating chunks...\n");
+
+    PseudoFile_reserve(output, offset, &status);
+
+    AsmCache new_cache = {};
+    size_t cache_hits = 0;
+    if (cache) AsmCache_ctor(&new_cache, cache->capacity);
+
+    for (size_t chunk_id = 0; chunk_id < chunk_count; ++chunk_id) {
+        AsmChunk* chunk = &chunks[chunk_id];
+
+        if (chunk->err_code) status = chunk->err_code;
+
+        if (output->content && output->size + chunk->code.size <= output->capacity) {
+            memcpy(output->content + output->size, chunk->code.content, chunk->code.size);
+            output->size += chunk->code.size;
+        }
+
+        PseudoFile_append(data, chunk->data.content, chunk->data.size, &status);
+
+        if (link) {
+            PseudoFile_append(&link->exports, chunk->link.exports.content, chunk->link.exports.size, &status);
+            PseudoFile_append(&link->relocations, chunk->link.relocations.content, chunk->link.relocations.size, &status);
+        }
+
+        if (map) {
+            PseudoFile_append(&map->lines, chunk->map.lines.content, chunk->map.lines.size, &status);
+            PseudoFile_append(&map->labels, chunk->map.labels.content, chunk->map.labels.size, &status);
+            map->label_count += chunk->map.label_count;
+        }
+
+        if (listing && chunk->listing) fwrite(chunk->listing, sizeof(char), chunk->listing_size, listing);
+
+        for (size_t index = 0; index < chunk->new_cache.capacity; ++index) {
+            if (chunk->new_cache.entries[index].line_hash) cache_insert(&new_cache, &chunk->new_cache.entries[index]);
+        }
+        cache_hits += chunk->cache_hits;
+
+        AsmChunk_dtor(chunk);
+        LabelSet_dtor(&local_labels[chunk_id]);
+    }
+
+    free(chunks);
+    free(local_labels);
+
+    if (cache) {
+        printf("Reused %lu of %lu lines from the assembly cache.\n", cache_hits, line_count);
+
+        AsmCache_dtor(cache);
+        *cache = new_cache;
+    }
+
+    if (status && err_code) *err_code = status;
 }
 
-void assemble(LabelSet* labels, FILE* listing, char** lines, size_t line_count, int* err_code) {
-    _LOG_FAIL_CHECK_(output_content.content, "error", ERROR_REPORTS, return, err_code, ENOENT);
-    for (size_t line_id = 0; line_id < line_count; ++line_id) {
-        log_printf(STATUS_REPORTS, "status", "Processing line %s.\n", lines[line_id]);
-        process_line(labels, lines[line_id], listing, &errno);
+void run_chunks(AsmChunk* chunks, size_t chunk_count) {
+    pthread_t threads[MAX_ASM_THREADS] = {};
+    bool spawned[MAX_ASM_THREADS] = {};
+
+    //* The first chunk is always assembled by the calling thread.
+    for (size_t chunk_id = 1; chunk_id < chunk_count; ++chunk_id) {
+        spawned[chunk_id] = pthread_create(&threads[chunk_id], NULL, assemble_chunk, &chunks[chunk_id]) == 0;
+        if (!spawned[chunk_id]) assemble_chunk(&chunks[chunk_id]);
+    }
+
+    assemble_chunk(&chunks[0]);
+
+    for (size_t chunk_id = 1; chunk_id < chunk_count; ++chunk_id) {
+        if (spawned[chunk_id]) pthread_join(threads[chunk_id], NULL);
     }
 }
 
-#define DEF_CMD(name, parse_script, exec_script, disasm_script) \
-    if (hash == CMD_HASHES[CMD_##name]) {sequence[0] = (CMD_##name << 2); ++cmd_size; parse_script;} else
+void* assemble_chunk(void* chunk_ptr) {
+    AsmChunk* chunk = (AsmChunk*) chunk_ptr;
+
+    FILE* listing = NULL;
+    if (chunk->final_pass) listing = open_memstream(&chunk->listing, &chunk->listing_size);
+
+    for (size_t line_id = 0; line_id < chunk->line_count; ++line_id) {
+        log_printf(STATUS_REPORTS, "status", "Processing line %.*s.\n",
+                   (int)chunk->lines[line_id].length, chunk->lines[line_id].start);
+        process_line(chunk, &chunk->lines[line_id], listing, &chunk->err_code);
+    }
 
-#define ARG_PTR                 ( line + shift )
-#define GET_LABEL(arg)          get_label(arg, err_code)
-#define CUR_ID                  ( output_content.size + HEADER_SIZE )
-#define BUF_PTR                 sequence
-#define BUF_WRITE(ptr, length)  { memcpy(sequence + cmd_size, ptr, length); cmd_size += length; }
-#define ERRNO                   err_code
-#define LABEL_LIST              labels
+    if (listing) fclose(listing);
 
-#define if_cmd_not_defined
+    return NULL;
+}
 
-void process_line(LabelSet* labels, const char* line, FILE* listing, int* const err_code) {
+#define CUR_ID                  ( chunk->base + chunk->code.size + HEADER_SIZE )
+
+void process_line(AsmChunk* chunk, const TextLine* line, FILE* listing, int* const err_code) {
     _LOG_FAIL_CHECK_(line, "error", ERROR_REPORTS, return, NULL, 0);
 
-    char first_char = '\0';
-    sscanf(line, " %c", &first_char);
+    const char* line_end = line->start + line->length;
+    const char* code_end = NULL;
+    const char* code = next_word(line->start, line_end, &code_end);
 
+    //* Commands are parsed from a NUL-terminated copy of the line, cached lines are never copied.
+    char text[MAX_LINE_LENGTH] = "";
     int shift = 0;
-    char code[10] = "";
     char sequence[MAX_CMD_BITE_LENGTH] = "";
     size_t cmd_size = 0;
+    unsigned int cmd_id = 0;
     hash_t hash = 0;
+    hash_t line_hash = 0;
+    bool cacheable = false;
+
+    chunk->encoder.dep_count = 0;
     
-    if (*line != '\0' && first_char != CMD_COMMENT_CHAR) do {
+    if (code != line_end && *code != CMD_COMMENT_CHAR) do {
 
-        sscanf(line, "%s%n", code, &shift);
-        hash = get_hash(code, code + strlen(code));
+        hash = get_hash(code, code_end);
 
         if (hash == CMD_LABEL_HASH) {
-            char lbl_name[LABEL_MAX_NAME_LENGTH] = "";
-            sscanf(line + shift, "%s", lbl_name);
+            const char* lbl_name_end = NULL;
+            const char* lbl_name = next_word(code_end, line_end, &lbl_name_end);
+
+            if (chunk->final_pass) {
+                if (chunk->mapped) map_label(chunk, lbl_name, lbl_name_end, err_code);
+                break;
+            }
             
-            hash_t lbl_hash = get_hash(lbl_name, lbl_name + strlen(lbl_name));
-            add_label(labels, lbl_hash, output_content.size + HEADER_SIZE, err_code);
+            hash_t lbl_hash = get_hash(lbl_name, lbl_name_end);
+            add_label(chunk->labels, lbl_hash, CUR_ID, err_code);
             
-            log_printf(STATUS_REPORTS, "status", "Label %s was set to %0*X.\n", lbl_name, sizeof(uintptr_t), output_content.size);
+            log_printf(STATUS_REPORTS, "status", "Label %.*s was set to %0*X.\n",
+                       (int)(lbl_name_end - lbl_name), lbl_name, sizeof(uintptr_t), CUR_ID);
             
             break;
         }
 
-        #include "cmddef.h"
+        if (hash == CMD_GLOBAL_HASH) {
+            if (!chunk->final_pass || !chunk->relocatable) break;
+
+            const char* lbl_name_end = NULL;
+            const char* lbl_name = next_word(code_end, line_end, &lbl_name_end);
+
+            hash_t lbl_hash = get_hash(lbl_name, lbl_name_end);
+            PseudoFile_append(&chunk->link.exports, &lbl_hash, sizeof(lbl_hash), err_code);
+
+            break;
+        }
+
+        if (hash == CMD_DATA_HASH || hash == CMD_FILL_HASH || hash == CMD_STRING_HASH) {
+            if (!chunk->final_pass || !copy_line(line, text, err_code)) break;
+
+            DataDirective directive = hash == CMD_FILL_HASH   ? DATA_FILL   :
+                                      hash == CMD_STRING_HASH ? DATA_STRING : DATA_VALUES;
+
+            parse_data_directive(&chunk->data, directive, text + (code_end - line->start), err_code);
+            break;
+        }
+
+        //* Fused commands span two lines and are never cached.
+        const TextLine* previous = command_line_near(chunk, line, -1);
+        if (previous && fuse_lines(chunk, previous, text)) break;
+
+        bool fused = fuse_lines(chunk, line, text);
+
+        if (chunk->cache && !fused) {
+            line_hash = get_hash(line->start, line_end);
+            cacheable = true;
+
+            const CacheEntry* entry = cache_find(chunk->cache, line_hash, chunk->final_pass ? chunk->labels : NULL, CUR_ID);
+            if (entry) {
+                memcpy(sequence, entry->content, entry->size);
+                cmd_size = entry->size;
+                memcpy(chunk->encoder.deps, entry->deps, sizeof(chunk->encoder.deps));
+                chunk->encoder.dep_count = entry->dep_count;
+                if (chunk->final_pass) ++chunk->cache_hits;
+                break;
+            }
+        }
+
+        if (fused) {
+            code = next_word(text, text + strlen(text), &code_end);
+            hash = get_hash(code, code_end);
+            shift = (int)(code_end - text);
+        } else {
+            if (!copy_line(line, text, err_code)) {
+                cacheable = false;
+                break;
+            }
+
+            shift = (int)(code_end - line->start);
+        }
+
+        chunk->encoder.labels = chunk->labels;
+        chunk->encoder.position = CUR_ID;
+
+        cmd_size = encode_command(&chunk->encoder, hash, text, shift, sequence, &cmd_id, err_code);
 
-        if_cmd_not_defined log_printf(ERROR_REPORTS, "error", "Unknown command %s.\n", code);
+        if (cmd_size == 0) {
+            log_printf(ERROR_REPORTS, "error", "Unknown command %.*s.\n", (int)(code_end - code), code);
+            cacheable = false;
+            break;
+        }
+
+        _LOG_FAIL_CHECK_(cmd_size == (size_t)cmd_length(cmd_id), "error", ERROR_REPORTS, {
+            log_printf(ERROR_REPORTS, "error", "Command %s was encoded into %lu bytes instead of %d.\n",
+                                               CMD_INFO[cmd_id].name, cmd_size, cmd_length(cmd_id));
+            cacheable = false;
+        }, err_code, EINVAL);
     } while (0);
 
-    log_printf(STATUS_REPORTS, "status", "Writing command to the file, cmd size -> %ld.\n", cmd_size);
-    memcpy(output_content.content + output_content.size, sequence, cmd_size);
+    if (chunk->final_pass && cacheable && cmd_size <= MAX_CACHED_CMD_LENGTH && chunk->encoder.dep_count <= MAX_LABEL_DEPS) {
+        CacheEntry entry = {};
+        entry.line_hash = line_hash;
+        entry.env_hash = label_env_hash(chunk->labels, chunk->encoder.deps, chunk->encoder.dep_count, CUR_ID);
+        memcpy(entry.deps, chunk->encoder.deps, sizeof(entry.deps));
+        entry.dep_count = chunk->encoder.dep_count;
+        entry.size = cmd_size;
+        memcpy(entry.content, sequence, cmd_size);
+
+        cache_insert(&chunk->new_cache, &entry, err_code);
+    }
+
+    if (chunk->final_pass && chunk->relocatable) record_relocations(chunk, cmd_size, err_code);
+
+    if (chunk->final_pass && chunk->mapped && cmd_size) {
+        LineMapping mapping = {};
+        mapping.offset = (uint32_t)CUR_ID;
+        mapping.line = (uint32_t)(chunk->first_line + (size_t)(line - chunk->lines));
+
+        PseudoFile_append(&chunk->map.lines, &mapping, sizeof(mapping), err_code);
+    }
+
+    log_printf(STATUS_REPORTS, "status", "Writing command to the chunk, cmd size -> %ld.\n", cmd_size);
+    PseudoFile_reserve(&chunk->code, cmd_size, err_code);
+    _LOG_FAIL_CHECK_(chunk->code.content || cmd_size == 0, "error", ERROR_REPORTS, return, err_code, ENOMEM);
+
+    if (cmd_size) memcpy(chunk->code.content + chunk->code.size, sequence, cmd_size);
     
-    output_content.size += cmd_size;
+    chunk->code.size += cmd_size;
     if (listing) {
-        fprintf(listing, "| %-36.36s  | [0x%0*lX] ", line, (int)sizeof(uintptr_t), output_content.size - cmd_size + HEADER_SIZE);
+        int shown_length = line->length < (size_t)LISTING_LINE_WIDTH ? (int)line->length : LISTING_LINE_WIDTH;
+        fprintf(listing, "| %-*.*s  | [0x%0*lX] ", LISTING_LINE_WIDTH, shown_length, line->start,
+                                                   (int)sizeof(uintptr_t), CUR_ID - cmd_size);
         for (int id = 0; id < (int)cmd_size; ++id) {
             fprintf(listing, " %02X", (unsigned int)sequence[id] & 0xFF);
         }
@@ -332,32 +856,119 @@ void process_line(LabelSet* labels, const char* line, FILE* listing, int* const
     }
 }
 
-#undef DEF_CMD
+const char* next_word(const char* ptr, const char* end, const char** word_end) {
+    while (ptr < end && isspace(*ptr)) ++ptr;
 
-void add_label(LabelSet* labels, hash_t hash, uintptr_t point, int* const err_code) {
-    _LOG_FAIL_CHECK_(labels->array, "error", ERROR_REPORTS, return, err_code, ENOENT);
-    _LOG_FAIL_CHECK_(labels->size < labels->max_size, "error", ERROR_REPORTS, return, err_code, ENOMEM);
+    const char* word = ptr;
+    while (ptr < end && !isspace(*ptr)) ++ptr;
 
-    for (size_t label_id = 0; label_id < labels->size; ++label_id) {
-        if (hash == labels->array[label_id].hash) {
-            labels->array[label_id].point = point;
-            return;
-        }
+    if (word_end) *word_end = ptr;
+    return word;
+}
+
+bool fuse_lines(const AsmChunk* chunk, const TextLine* line, char* text) {
+    static const unsigned int FUSIONS[][2] = {
+        { CMD_ADD,   CMD_ADDI   }, { CMD_SUB,   CMD_SUBI   }, { CMD_MUL,  CMD_MULI  }, { CMD_DIV,  CMD_DIVI  },
+        { CMD_JMPG,  CMD_JMPGI  }, { CMD_JMPL,  CMD_JMPLI  }, { CMD_JMPE, CMD_JMPEI },
+        { CMD_JMPGE, CMD_JMPGEI }, { CMD_JMPLE, CMD_JMPLEI },
+    };
+
+    if (!chunk->fuse || line->length >= MAX_LINE_LENGTH) return false;
+
+    const char* line_end = line->start + line->length;
+    const char* word_end = NULL;
+    const char* word = next_word(line->start, line_end, &word_end);
+    if (word == line_end || get_hash(word, word_end) != CMD_HASHES[CMD_PUSH]) return false;
+
+    //* Only literal integers and characters are constants, registers and RAM cells can change.
+    const char* value = next_word(word_end, line_end, NULL);
+    if (value == line_end || !(isdigit(*value) || *value == '-' || *value == '\'')) return false;
+
+    memcpy(text, line->start, line->length);
+    text[line->length] = '\0';
+
+    PPArgument argument = read_pparg(text + (word_end - line->start));
+    double real = 0;
+    if (argument.props != 0 || read_float(text + (word_end - line->start), &real) > argument.length) return false;
+
+    const TextLine* next = command_line_near(chunk, line, 1);
+    if (!next) return false;
+
+    const char* next_end = next->start + next->length;
+    word = next_word(next->start, next_end, &word_end);
+    if (word == next_end) return false;
+
+    hash_t hash = get_hash(word, word_end);
+
+    for (size_t fusion_id = 0; fusion_id < sizeof(FUSIONS) / sizeof(*FUSIONS); ++fusion_id) {
+        if (hash != CMD_HASHES[FUSIONS[fusion_id][0]]) continue;
+
+        //* Stack operations with operands are register-direct commands that do not use the pushed value.
+        bool branch = CMD_INFO[FUSIONS[fusion_id][0]].flags & CMD_F_BRANCH;
+        if (!branch && next_word(word_end, next_end, NULL) != next_end) return false;
+
+        int length = snprintf(text, MAX_LINE_LENGTH, "%s %d%.*s", CMD_SOURCE[FUSIONS[fusion_id][1]], argument.value,
+                              (int)(next_end - word_end), word_end);
+        return length > 0 && (size_t)length < MAX_LINE_LENGTH;
     }
 
-    labels->array[labels->size].hash  = hash;
-    labels->array[labels->size].point = point;
-    ++labels->size;
+    return false;
 }
 
-uintptr_t get_label(LabelSet* labels, hash_t hash, int* const err_code) {
-    _LOG_FAIL_CHECK_(labels->array, "error", ERROR_REPORTS, return 0, err_code, ENOENT);
+const TextLine* command_line_near(const AsmChunk* chunk, const TextLine* line, int step) {
+    while (step < 0 ? line > chunk->text_begin : line + 1 < chunk->text_end) {
+        line += step;
 
-    for (size_t label_id = 0; label_id < labels->size; ++label_id) {
-        if (hash == labels->array[label_id].hash) return labels->array[label_id].point;
+        const char* line_end = line->start + line->length;
+        const char* word = next_word(line->start, line_end, NULL);
+        if (word != line_end && *word != CMD_COMMENT_CHAR) return line;
     }
 
-    int status = 0;
-    add_label(labels, hash, 0, &status);
-    return status == 0 ? labels->array[labels->size - 1].point : 0;
+    return NULL;
+}
+
+bool copy_line(const TextLine* line, char* text, int* const err_code) {
+    _LOG_FAIL_CHECK_(line->length < MAX_LINE_LENGTH, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Line \"%.*s...\" is longer than %lu characters.\n",
+                   LISTING_LINE_WIDTH, line->start, MAX_LINE_LENGTH - 1);
+        return false;
+    }, err_code, E2BIG);
+
+    memcpy(text, line->start, line->length);
+    text[line->length] = '\0';
+    return true;
+}
+
+void map_label(AsmChunk* chunk, const char* name, const char* name_end, int* const err_code) {
+    static const char padding[sizeof(uint32_t)] = {};
+
+    uint32_t record[] = { (uint32_t)CUR_ID, (uint32_t)(name_end - name) };
+    size_t padding_size = (sizeof(padding) - record[1] % sizeof(padding)) % sizeof(padding);
+
+    PseudoFile_append(&chunk->map.labels, record, sizeof(record), err_code);
+    PseudoFile_append(&chunk->map.labels, name, record[1], err_code);
+    PseudoFile_append(&chunk->map.labels, padding, padding_size, err_code);
+    ++chunk->map.label_count;
+}
+
+void record_relocations(AsmChunk* chunk, size_t cmd_size, int* const err_code) {
+    size_t external_count = 0;
+
+    for (size_t dep_id = 0; dep_id < chunk->encoder.dep_count && dep_id < MAX_LABEL_DEPS; ++dep_id) {
+        if (get_label(chunk->labels, chunk->encoder.deps[dep_id])) continue;
+
+        ObjRelocation relocation = {};
+        relocation.symbol = chunk->encoder.deps[dep_id];
+        relocation.instruction = (uint32_t)(CUR_ID - HEADER_SIZE);
+        relocation.operand = (uint32_t)(relocation.instruction + cmd_size - sizeof(int));
+
+        _LOG_FAIL_CHECK_(++external_count == 1 && cmd_size >= 1 + sizeof(int), "error", ERROR_REPORTS, {
+            log_printf(ERROR_REPORTS, "error", "Instruction at 0x%0*lX can not refer to label with hash %llX "
+                                               "declared in another module.\n",
+                                               (int)sizeof(uintptr_t), CUR_ID, relocation.symbol);
+            return;
+        }, err_code, EINVAL);
+
+        PseudoFile_append(&chunk->link.relocations, &relocation, sizeof(relocation), err_code);
+    }
 }
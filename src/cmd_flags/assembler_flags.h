@@ -21,4 +21,27 @@
 
 { {'F', ""},    { bundle(1, &out_size),         1, edit_int },
     "set maximum output file size.\n"
-    "\tDoes not check if integer was specified." },
\ No newline at end of file
+    "\tDoes not check if integer was specified." },
+
+{ {'T', ""},    { bundle(1, &thread_count),     1, edit_int },
+    "set number of assembly threads (0 - one per online processor).\n"
+    "\tDoes not check if integer was specified." },
+
+{ {'C', ""},    { bundle(1, cache_name),        1, edit_string },
+    "set incremental reassembly cache file name (caching is disabled by default).\n"
+    "\tOnly lines that changed or moved relative to the labels they use are re-encoded." },
+
+{ {'c', "object"}, { bundle(1, &gen_object), 1, enable_flag },
+    "produce relocatable object file for the linker instead of a binary.\n"
+    "\tLabels exported with GLOBAL can be used by other modules." },
+
+{ {'p', "pack"}, { bundle(1, &pack), 1, enable_flag },
+    "pack commands into the dense form with variable-length arguments.\n"
+    "\tPacked code is expanded by the processor and the disassembler when the binary is loaded." },
+
+{ {'D', ""},    { bundle(1, map_name),          1, edit_string },
+    "write source map mapping code offsets to source lines and labels to the file.\n"
+    "\tSource map can be passed to the processor and the disassembler with the same flag." },
+{ {'n', "no-fuse"}, { bundle(1, &no_fuse), 1, enable_flag },
+    "do not replace constant pushes followed by arithmetic or conditional jumps with immediate commands.\n"
+    "\tUse it if the code jumps between the push and the command by numeric distances." },
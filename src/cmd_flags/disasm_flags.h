@@ -11,3 +11,14 @@
 
 #include "common_flags.h"
 
+{ {'D', ""}, { bundle(1, debug_name), 1, edit_string },
+    "load source map written by the assembler.\n"
+    "\tLabels are restored and instructions are annotated with their source lines." },
+
+{ {'G', "graph"}, { bundle(1, graph_name), 1, edit_string },
+    "write control flow graph of the program to the file in Graphviz DOT format.\n"
+    "\tBlocks are annotated with their sizes and shaded by loop depth." },
+
+{ {'T', ""}, { bundle(1, &thread_count), 1, edit_int },
+    "set number of disassembly threads (0 - one per online processor).\n"
+    "\tDoes not check if integer was specified." },
@@ -0,0 +1,16 @@
+/**
+ * @file linker_flags.h
+ * @author Kudryashov Ilya (kudriashov.it@phystech.edu)
+ * @brief List of command line arguments for linker.
+ * @version 0.1
+ * @date 2022-11-05
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#include "common_flags.h"
+
+{ {'o', ""},    { bundle(1, out_name),          1, edit_string },
+    "set output binary name (written right after the flag, for example -oprogram.bin).\n"
+    "\tObject files are placed in the order they are listed, execution starts with the first one." },
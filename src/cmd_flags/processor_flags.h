@@ -11,8 +11,8 @@
 
 #include "common_flags.h"
 
-{ {'R', ""}, { bundle(1, &reg.size), 1, edit_int},
-    "set max. number of cells register can hold.\n"
+{ {'G', ""}, { bundle(1, &reg.size), 1, edit_int},
+    "set number of registers (up to 256, registers above the limit can not be used).\n"
     "\tDoes not check if integer was specified." },
 
 { {'R', ""}, { bundle(1, &ram.size), 1, edit_int},
@@ -25,4 +25,15 @@
 
 { {'H', ""}, { bundle(1, &vmd.height), 1, edit_int },
     "set text screen height.\n"
-    "\tDoes not check if integer was specified."},
\ No newline at end of file
+    "\tDoes not check if integer was specified."},
+
+{ {'D', ""}, { bundle(1, debug_name), 1, edit_string },
+    "load source map written by the assembler.\n"
+    "\tFault locations and profile are reported as source lines and labels." },
+
+{ {'P', "profile"}, { bundle(1, &profile), 1, enable_flag },
+    "count instruction executions and write hottest source lines to " DEFAULT_PROFILE_NAME "." },
+
+{ {'C', "image-cache"}, { bundle(1, image_cache), 1, edit_string },
+    "set directory of verified program images (caching is disabled by default).\n"
+    "\tLater runs of the same binary map its image and skip decoding and verification." },
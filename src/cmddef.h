@@ -9,6 +9,12 @@
  * 
  */
 
+//* Command variants are only listed where DEF_ALIAS is defined.
+#ifndef DEF_ALIAS
+    #define DEF_ALIAS(name, command, variant, meta)
+    #define __DEF_ALIAS_DEFAULT
+#endif
+
 #ifdef ASSEMBLER
     #define ON_ASSEMBLER(...) _VA_ARGS_
     #ifndef ARG_PTR
@@ -17,6 +23,9 @@
     #ifndef GET_LABEL
         #error GET_LABEL was not defined while trying to access assembly code.
     #endif
+    #ifndef GET_DISTANCE
+        #error GET_DISTANCE was not defined while trying to access assembly code.
+    #endif
     #ifndef CUR_ID
         #error CUR_ID was not defined while trying to access assembly code.
     #endif
@@ -29,6 +38,9 @@
     #ifndef LABEL_LIST
         #error LABEL_LIST was not defined while trying to access assembly code.
     #endif
+    #ifndef VARIANT
+        #error VARIANT was not defined while trying to access assembly code.
+    #endif
 #endif
 #ifdef PROCESSOR
     #define ON_PROCESSOR(...) _VA_ARGS_
@@ -38,6 +50,9 @@
     #ifndef ADDR_STACK
         #error ADDR_STACK was not defined while trying to access execution code.
     #endif
+    #ifndef FRAMES
+        #error FRAMES was not defined while trying to access execution code.
+    #endif
     #ifndef SHIFT
         #error SHIFT was not defined while trying to access execution code.
     #endif
@@ -91,4 +106,21 @@
 #include "cmds/flow.h"
 #include "cmds/memops.h"
 #include "cmds/arifm.h"
-#include "cmds/interaction.h"
\ No newline at end of file
+#include "cmds/interaction.h"
+#include "cmds/immediate.h"
+#include "cmds/counters.h"
+#include "cmds/registers.h"
+#include "cmds/bulkmem.h"
+#include "cmds/raster.h"
+#include "cmds/floats.h"
+#include "cmds/native_calls.h"
+#include "cmds/frames.h"
+#include "cmds/strings.h"
+#include "cmds/timing.h"
+#include "cmds/threads.h"
+#include "cmds/pfor.h"
+
+#ifdef __DEF_ALIAS_DEFAULT
+    #undef DEF_ALIAS
+    #undef __DEF_ALIAS_DEFAULT
+#endif
\ No newline at end of file
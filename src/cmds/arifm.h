@@ -4,12 +4,25 @@
     PUSH(arg_a operation arg_b); \
 }
 
-DEF_CMD(ADD, {}, __STACK_ELEM_OPERATION(+), {})
+//* Operation with register operands is switched to its register-direct form (see registers.h).
+#define __STACK_ELEM_ASM(reg_name) { \
+    unsigned char regs[sizeof(int)] = {}; \
+    if (read_register_operands(ARG_PTR, regs, ERRNO)) { \
+        BUF_PTR[0] = (char)(CMD_##reg_name << 2); \
+        BUF_WRITE(regs, sizeof(regs)); \
+    } \
+}
+
+#define __STACK_ELEM_META CMD_META(0, 2, 1, 0)
+
+DEF_CMD(ADD, __STACK_ELEM_META, __STACK_ELEM_ASM(ADDR), __STACK_ELEM_OPERATION(+), {})
 
-DEF_CMD(SUB, {}, __STACK_ELEM_OPERATION(-), {})
+DEF_CMD(SUB, __STACK_ELEM_META, __STACK_ELEM_ASM(SUBR), __STACK_ELEM_OPERATION(-), {})
 
-DEF_CMD(MUL, {}, __STACK_ELEM_OPERATION(*), {})
+DEF_CMD(MUL, __STACK_ELEM_META, __STACK_ELEM_ASM(MULR), __STACK_ELEM_OPERATION(*), {})
 
-DEF_CMD(DIV, {}, __STACK_ELEM_OPERATION(/), {})
+DEF_CMD(DIV, __STACK_ELEM_META, __STACK_ELEM_ASM(DIVR), __STACK_ELEM_OPERATION(/), {})
 
+#undef __STACK_ELEM_META
+#undef __STACK_ELEM_ASM
 #undef __STACK_ELEM_OPERATION
\ No newline at end of file
@@ -0,0 +1,78 @@
+//* Bulk RAM commands take their operands from registers, MEMSET RDX RCX RAX puts RAX into RCX cells starting at [RDX].
+//* Bounds are checked once per command, cells are processed by vector kernels from mem_kernels.h.
+
+#define __BULK_ASM(name, count) { \
+    unsigned char regs[sizeof(int)] = {}; \
+    _LOG_FAIL_CHECK_(read_registers(ARG_PTR, regs, count, ERRNO) == count, "error", ERROR_REPORTS, { \
+        log_printf(ERROR_REPORTS, "error", #name " takes %d registers as operands.\n", count); \
+    }, ERRNO, EINVAL); \
+    BUF_WRITE(regs, sizeof(regs)); \
+}
+
+//* Declares operands[] with register values and status of their linkage.
+#define __BULK_OPERANDS(count) \
+    unsigned char regs[sizeof(int)] = {}; \
+    memcpy(regs, ARG_PTR, sizeof(regs)); \
+    int operands[count] = {}; \
+    int status = 0; \
+    for (int id = 0; id < count && !status; ++id) { \
+        int* operand = link_argument(USE_REGISTER, regs[id], NULL, RAM, REG, &status); \
+        if (!status) operands[id] = *operand; \
+    }
+
+#define __BULK_FAIL_CHECK \
+    if (status) { \
+        SHIFT = 0; \
+        log_printf(ERROR_REPORTS, "error", "Invalid operands of %s at %0*X.\n", COMMAND_NAME, sizeof(void*), EXEC_POINT); \
+    }
+
+#define __BULK_DISASM(count) { \
+    unsigned char regs[sizeof(int)] = {}; \
+    memcpy(regs, ARG_PTR, sizeof(regs)); \
+    for (int id = 0; id < count; ++id) { \
+        if (id) fputc(' ', OUT_FILE); \
+        write_register(OUT_FILE, regs[id]); \
+    } \
+}
+
+//* MEMSET dest count value
+DEF_CMD(MEMSET, CMD_META(sizeof(int), 0, 0, 0), __BULK_ASM(MEMSET, 3), {
+    __BULK_OPERANDS(3);
+    int* dest = status ? NULL : link_ram_range(RAM, operands[0], operands[1], &status);
+    if (dest) mem_fill(dest, (size_t)operands[1], operands[2]);
+    __BULK_FAIL_CHECK;
+}, __BULK_DISASM(3))
+
+//* MEMCPY dest source count
+DEF_CMD(MEMCPY, CMD_META(sizeof(int), 0, 0, 0), __BULK_ASM(MEMCPY, 3), {
+    __BULK_OPERANDS(3);
+    int* dest   = status ? NULL : link_ram_range(RAM, operands[0], operands[2], &status);
+    int* source = status ? NULL : link_ram_range(RAM, operands[1], operands[2], &status);
+    if (dest && source) mem_copy(dest, source, (size_t)operands[2]);
+    __BULK_FAIL_CHECK;
+}, __BULK_DISASM(3))
+
+//* MEMSUM source count
+DEF_CMD(MEMSUM, CMD_META(sizeof(int), 0, 1, 0), __BULK_ASM(MEMSUM, 2), {
+    __BULK_OPERANDS(2);
+    int* source = status ? NULL : link_ram_range(RAM, operands[0], operands[1], &status);
+    if (source) PUSH(mem_sum(source, (size_t)operands[1]));
+    __BULK_FAIL_CHECK;
+}, __BULK_DISASM(2))
+
+//* MEMMAX source count
+DEF_CMD(MEMMAX, CMD_META(sizeof(int), 0, 1, 0), __BULK_ASM(MEMMAX, 2), {
+    __BULK_OPERANDS(2);
+    int* source = status ? NULL : link_ram_range(RAM, operands[0], operands[1], &status);
+    _LOG_FAIL_CHECK_(status || operands[1] > 0, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "MEMMAX of an empty range.\n");
+        status = EINVAL;
+    }, ERRNO, EINVAL);
+    if (!status) PUSH(mem_max(source, (size_t)operands[1]));
+    __BULK_FAIL_CHECK;
+}, __BULK_DISASM(2))
+
+#undef __BULK_ASM
+#undef __BULK_OPERANDS
+#undef __BULK_FAIL_CHECK
+#undef __BULK_DISASM
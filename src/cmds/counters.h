@@ -0,0 +1,107 @@
+//* Counter commands change registers and RAM cells in place, their argument is written as MOVE destination.
+
+#define __COUNTER_WRITE(counter) { \
+    _LOG_FAIL_CHECK_(counter.props != 0, "error", ERROR_REPORTS, { \
+        log_printf(ERROR_REPORTS, "error", "Counter \"%s\" is not a register or RAM cell.\n", ARG_PTR); \
+    }, ERRNO, EINVAL); \
+    BUF_WRITE(&counter.value, sizeof(counter.value)); \
+    BUF_PTR[0] |= counter.props; \
+    BUF_PTR[1] = (char)counter.reg; \
+}
+
+#define __COUNTER_ASM { \
+    check_register_name(ARG_PTR, ERRNO); \
+    PPArgument counter = read_pparg(ARG_PTR); \
+    __COUNTER_WRITE(counter); \
+}
+
+//* Counter that is already at the limit would leave the range of a memory cell.
+#define __COUNTER_FAIL_CHECK(value, limit) \
+    _LOG_FAIL_CHECK_((value) != (limit), "error", ERROR_REPORTS, { \
+        log_printf(ERROR_REPORTS, "error", "Counter value %d would leave the memory cell range at %0*X.\n", \
+                   value, sizeof(void*), EXEC_POINT); \
+        SHIFT = 0; \
+    }, ERRNO, ERANGE)
+
+#define __COUNTER_RUN(operation, limit) { \
+    int arg = 0; \
+    memcpy(&arg, ARG_PTR, sizeof(arg)); \
+    char usage = *EXEC_POINT & 3; \
+    int status = 0; \
+    int* subject = link_argument(usage, (unsigned char)EXEC_POINT[1], &arg, RAM, REG, &status); \
+    if (status) { \
+        SHIFT = 0; \
+        log_printf(ERROR_REPORTS, "error", "Failed to link command argument at %0*X.\n", sizeof(void*), EXEC_POINT); \
+    } else { \
+        __COUNTER_FAIL_CHECK(*subject, limit); \
+        if (*subject != (limit)) operation*subject; \
+    } \
+}
+
+#define __COUNTER_DISASM { \
+    int arg = 0; \
+    memcpy(&arg, ARG_PTR, sizeof(arg)); \
+    write_argument(OUT_FILE, *EXEC_POINT & 3, (unsigned char)EXEC_POINT[1], arg); \
+}
+
+DEF_CMD(INC, CMD_META(sizeof(int), 0, 0, CMD_F_MASKED), __COUNTER_ASM, __COUNTER_RUN(++, INT_MAX), __COUNTER_DISASM)
+
+DEF_CMD(DEC, CMD_META(sizeof(int), 0, 0, CMD_F_MASKED), __COUNTER_ASM, __COUNTER_RUN(--, INT_MIN), __COUNTER_DISASM)
+
+//* LOOP counter limit label increments the counter and jumps to the label while it is less than the limit.
+DEF_CMD(LOOP, CMD_META(3 * sizeof(int), 0, 0, CMD_F_MASKED | CMD_F_BRANCH | CMD_F_COND), {
+    check_register_name(ARG_PTR, ERRNO);
+    PPArgument counter = read_pparg(ARG_PTR);
+    __COUNTER_WRITE(counter);
+
+    const char* limit_ptr = ARG_PTR + counter.length;
+    limit_ptr += strspn(limit_ptr, " \t,");
+
+    int limit = 0;
+    const char* lbl_ptr = limit_ptr + read_immediate(limit_ptr, &limit, ERRNO);
+    lbl_ptr += strspn(lbl_ptr, " \t,");
+
+    int argument = GET_DISTANCE(lbl_ptr);
+
+    BUF_WRITE(&limit, sizeof(limit));
+    BUF_WRITE(&argument, sizeof(argument));
+}, {
+    int arg = 0;
+    int limit = 0;
+    int dest = 0;
+    memcpy(&arg, ARG_PTR, sizeof(arg));
+    memcpy(&limit, ARG_PTR + sizeof(arg), sizeof(limit));
+    memcpy(&dest, ARG_PTR + sizeof(arg) + sizeof(limit), sizeof(dest));
+
+    _LOG_FAIL_CHECK_(dest != 0, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "LOOP argument was 0, terminating.\n");
+    }, ERRNO, EFAULT);
+
+    char usage = *EXEC_POINT & 3;
+    int status = 0;
+    int* subject = link_argument(usage, (unsigned char)EXEC_POINT[1], &arg, RAM, REG, &status);
+    if (status) {
+        SHIFT = 0;
+        log_printf(ERROR_REPORTS, "error", "Failed to link command argument at %0*X.\n", sizeof(void*), EXEC_POINT);
+    } else {
+        __COUNTER_FAIL_CHECK(*subject, INT_MAX);
+        if (*subject != INT_MAX && ++*subject < limit) SHIFT = dest;
+    }
+}, {
+    int arg = 0;
+    int limit = 0;
+    int dest = 0;
+    memcpy(&arg, ARG_PTR, sizeof(arg));
+    memcpy(&limit, ARG_PTR + sizeof(arg), sizeof(limit));
+    memcpy(&dest, ARG_PTR + sizeof(arg) + sizeof(limit), sizeof(dest));
+
+    write_argument(OUT_FILE, *EXEC_POINT & 3, (unsigned char)EXEC_POINT[1], arg);
+    fprintf(OUT_FILE, " %d ", limit);
+    PRINT_TARGET(dest);
+})
+
+#undef __COUNTER_WRITE
+#undef __COUNTER_ASM
+#undef __COUNTER_FAIL_CHECK
+#undef __COUNTER_RUN
+#undef __COUNTER_DISASM
@@ -0,0 +1,74 @@
+//* Floating-point commands treat stack cells as doubles, ITOF and FTOI convert them from and to integers.
+//* FADD, FSUB, FMUL, FDIV, FSQRT, ITOF, FTOI and OUTF share one opcode, PUSH with a fractional literal is written as PUSHF.
+
+DEF_CMD(PUSHF, CMD_META(sizeof(double), 0, 1, 0), {
+    double value = 0;
+    _LOG_FAIL_CHECK_(read_float(ARG_PTR, &value) > 0, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Argument \"%s\" is not a number.\n", ARG_PTR);
+    }, ERRNO, EINVAL);
+    BUF_WRITE(&value, sizeof(value));
+}, {
+    double value = 0;
+    memcpy(&value, ARG_PTR, sizeof(value));
+    PUSH(pack_double(value));
+}, {
+    double value = 0;
+    memcpy(&value, ARG_PTR, sizeof(value));
+    fprintf(OUT_FILE, "%.17g", value);
+})
+
+#define __FLOAT_OPERATION(operation) { \
+    GET_TOP(stack_content_t arg_a); POP_TOP(); \
+    GET_TOP(stack_content_t arg_b); POP_TOP(); \
+    PUSH(pack_double(unpack_double(arg_a) operation unpack_double(arg_b))); \
+}
+
+DEF_CMD(FADD, CMD_META(sizeof(int), 2, 1, CMD_F_VARIANT), {
+    unsigned char selector[sizeof(int)] = { VARIANT };
+    BUF_WRITE(selector, sizeof(selector));
+}, {
+    switch ((unsigned char)*(ARG_PTR)) {
+        case 0: __FLOAT_OPERATION(+); break;
+        case 1: __FLOAT_OPERATION(-); break;
+        case 2: __FLOAT_OPERATION(*); break;
+        case 3: __FLOAT_OPERATION(/); break;
+        case 4: {
+            GET_TOP(stack_content_t value); POP_TOP();
+            PUSH(pack_double(sqrt(unpack_double(value))));
+        } break;
+        case 5: {
+            GET_TOP(stack_content_t value); POP_TOP();
+            PUSH(pack_double((double)value));
+        } break;
+        case 6: {
+            GET_TOP(stack_content_t value); POP_TOP();
+            double real = unpack_double(value);
+            bool fits = -0x1p63 <= real && real < 0x1p63;
+            _LOG_FAIL_CHECK_(fits, "error", ERROR_REPORTS, {
+                log_printf(ERROR_REPORTS, "error", "Value %g can not be converted to an integer.\n", real);
+                SHIFT = 0;
+            }, ERRNO, ERANGE);
+            if (fits) PUSH((stack_content_t)real);
+        } break;
+        case 7: {
+            _LOG_EMPT_STACK_(cmd_name(EXEC_POINT));
+            char text[32] = "";
+            int length = snprintf(text, sizeof(text), "%g", unpack_double(stack_get(STACK, ERRNO)));
+            if (length > 0) console_write(text, (size_t)length);
+        } break;
+        default: {
+            log_printf(ERROR_REPORTS, "error", "Unknown floating-point operation %d.\n", (unsigned char)*(ARG_PTR));
+            SHIFT = 0;
+        }
+    }
+}, {})
+
+DEF_ALIAS(FSUB,  FADD, 1, CMD_META(sizeof(int), 2, 1, CMD_F_VARIANT))
+DEF_ALIAS(FMUL,  FADD, 2, CMD_META(sizeof(int), 2, 1, CMD_F_VARIANT))
+DEF_ALIAS(FDIV,  FADD, 3, CMD_META(sizeof(int), 2, 1, CMD_F_VARIANT))
+DEF_ALIAS(FSQRT, FADD, 4, CMD_META(sizeof(int), 1, 1, CMD_F_VARIANT))
+DEF_ALIAS(ITOF,  FADD, 5, CMD_META(sizeof(int), 1, 1, CMD_F_VARIANT))
+DEF_ALIAS(FTOI,  FADD, 6, CMD_META(sizeof(int), 1, 1, CMD_F_VARIANT))
+DEF_ALIAS(OUTF,  FADD, 7, CMD_META(sizeof(int), 1, 1, CMD_F_IO | CMD_F_VARIANT))
+
+#undef __FLOAT_OPERATION
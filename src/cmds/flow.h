@@ -1,26 +1,16 @@
 #include "cond_jumps.h"
 
-DEF_CMD(END, {}, {
+DEF_CMD(END, CMD_META(0, 0, 0, CMD_F_TERMINATOR), {}, {
     SHIFT = 0;
 }, {})
 
-DEF_CMD(ABORT, {}, {
+DEF_CMD(ABORT, CMD_META(0, 0, 0, CMD_F_TERMINATOR), {}, {
     shift = 0;
     if (err_code) *err_code = EAGAIN;
 }, {})
 
-DEF_CMD(JMP, {
-    char lbl_name[LABEL_MAX_NAME_LENGTH] = "";
-    int argument = 0;
-
-    sscanf(ARG_PTR, "%d", &argument);
-
-    if (argument == 0) {
-        sscanf(ARG_PTR, "%s", lbl_name);
-        hash_t lbl_hash = get_hash(lbl_name, lbl_name + strlen(lbl_name));
-        argument = (int)get_label(LABEL_LIST, lbl_hash, ERRNO) - (int)CUR_ID;
-    }
-
+DEF_CMD(JMP, CMD_META(sizeof(int), 0, 0, CMD_F_BRANCH | CMD_F_TERMINATOR), {
+    int argument = GET_DISTANCE(ARG_PTR);
     BUF_WRITE(&argument, sizeof(argument));
 }, {
     int dest = 0;
@@ -32,29 +22,16 @@ DEF_CMD(JMP, {
 }, {
     int dest = 0;
     memcpy(&dest, ARG_PTR, sizeof(dest));
-    SHIFT += (int)sizeof(dest);
-    fprintf(OUT_FILE, "%d", dest);
+    PRINT_TARGET(dest);
 })
 
-DEF_CMD(CALL, {
-    char lbl_name[LABEL_MAX_NAME_LENGTH] = "";
-    int argument = 0;
-
-    sscanf(ARG_PTR, "%d", &argument);
-
-    if (argument == 0) {
-        sscanf(ARG_PTR, "%s", lbl_name);
-        hash_t lbl_hash = get_hash(lbl_name, lbl_name + strlen(lbl_name));
-        argument = (int)get_label(LABEL_LIST, lbl_hash, ERRNO) - (int)CUR_ID;
-    }
-
+DEF_CMD(CALL, CMD_META(sizeof(int), 0, 0, CMD_F_BRANCH | CMD_F_CALL), {
+    int argument = GET_DISTANCE(ARG_PTR);
     BUF_WRITE(&argument, sizeof(argument));
 }, {
     int dest = 0;
     memcpy(&dest, ARG_PTR, sizeof(dest));
 
-    SHIFT += (int)sizeof(dest);
-
     stack_push(ADDR_STACK, (stack_content_t)EXEC_POINT + SHIFT, ERRNO);
 
     SHIFT = dest;
@@ -66,12 +43,10 @@ DEF_CMD(CALL, {
     int dest = 0;
     memcpy(&dest, ARG_PTR, sizeof(dest));
 
-    SHIFT += (int)sizeof(dest);
-
-    fprintf(OUT_FILE, "%d", dest);
+    PRINT_TARGET(dest);
 })
 
-DEF_CMD(RET, {}, {
+DEF_CMD(RET, CMD_META(0, 0, 0, CMD_F_TERMINATOR), {}, {
     _LOG_FAIL_CHECK_(ADDR_STACK->size, "error", ERROR_REPORTS, {
         log_printf(ERROR_REPORTS, "error", "Address stack was empty when RET was called, terminating.");
         shift = 0;
@@ -0,0 +1,43 @@
+//* Local variable frames live on their own stack, ENTER n creates a frame with n zeroed variables and LEAVE removes it.
+//* LOAD.L k pushes variable k of the current frame, STORE.L k moves the last element of the stack into it.
+//* Argument is {variant, operand}, all four commands share one opcode.
+
+DEF_CMD(ENTER, CMD_META(2 * sizeof(int), 0, 0, CMD_F_VARIANT), {
+    int operands[2] = {};
+    operands[0] = VARIANT;
+    if (VARIANT != 1) read_immediate(ARG_PTR, &operands[1], ERRNO);
+    BUF_WRITE(operands, sizeof(operands));
+}, {
+    int operands[2] = {};
+    memcpy(operands, ARG_PTR, sizeof(operands));
+    bool success = false;
+    switch (operands[0]) {
+        case 0: success = frame_enter(FRAMES, operands[1], ERRNO); break;
+        case 1: success = frame_leave(FRAMES, ERRNO); break;
+        case 2: {
+            stack_content_t* local = frame_local(FRAMES, operands[1], ERRNO);
+            if (local) PUSH(*local);
+            success = local;
+        } break;
+        case 3: {
+            stack_content_t* local = frame_local(FRAMES, operands[1], ERRNO);
+            if (local) {
+                GET_TOP(*local); POP_TOP();
+            }
+            success = local;
+        } break;
+        default: log_printf(ERROR_REPORTS, "error", "Unknown frame operation %d.\n", operands[0]);
+    }
+    if (!success) {
+        SHIFT = 0;
+        log_printf(ERROR_REPORTS, "error", "%s failed at %0*X.\n", cmd_name(EXEC_POINT), sizeof(void*), EXEC_POINT);
+    }
+}, {
+    int operands[2] = {};
+    memcpy(operands, ARG_PTR, sizeof(operands));
+    if (operands[0] != 1) fprintf(OUT_FILE, "%d", operands[1]);
+})
+
+DEF_ALIAS(LEAVE,   ENTER, 1, CMD_META(2 * sizeof(int), 0, 0, CMD_F_VARIANT))
+DEF_ALIAS(LOAD.L,  ENTER, 2, CMD_META(2 * sizeof(int), 0, 1, CMD_F_VARIANT))
+DEF_ALIAS(STORE.L, ENTER, 3, CMD_META(2 * sizeof(int), 1, 0, CMD_F_VARIANT))
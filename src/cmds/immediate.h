@@ -0,0 +1,82 @@
+//* Commands with an immediate operand, ADDI c works as PUSH c + ADD and JMPGI c lbl as PUSH c + JMPG lbl.
+
+#define __IMM_ASM { \
+    int immediate = 0; \
+    read_immediate(ARG_PTR, &immediate, ERRNO); \
+    BUF_WRITE(&immediate, sizeof(immediate)); \
+}
+
+#define __IMM_OPERATION(operation) { \
+    int immediate = 0; \
+    memcpy(&immediate, ARG_PTR, sizeof(immediate)); \
+    GET_TOP(stack_content_t arg_b); POP_TOP(); \
+    PUSH(immediate operation arg_b); \
+}
+
+#define __IMM_DISASM { \
+    int immediate = 0; \
+    memcpy(&immediate, ARG_PTR, sizeof(immediate)); \
+    fprintf(OUT_FILE, "%d", immediate); \
+}
+
+#define __IMM_META CMD_META(sizeof(int), 1, 1, 0)
+
+DEF_CMD(ADDI, __IMM_META, __IMM_ASM, __IMM_OPERATION(+), __IMM_DISASM)
+
+DEF_CMD(SUBI, __IMM_META, __IMM_ASM, __IMM_OPERATION(-), __IMM_DISASM)
+
+DEF_CMD(MULI, __IMM_META, __IMM_ASM, __IMM_OPERATION(*), __IMM_DISASM)
+
+DEF_CMD(DIVI, __IMM_META, __IMM_ASM, __IMM_OPERATION(/), __IMM_DISASM)
+
+#define __IMM_JMP_ASM { \
+    int immediate = 0; \
+    int length = read_immediate(ARG_PTR, &immediate, ERRNO); \
+    int argument = GET_DISTANCE(ARG_PTR + length); \
+ \
+    BUF_WRITE(&immediate, sizeof(immediate)); \
+    BUF_WRITE(&argument, sizeof(argument)); \
+}
+
+#define __IMM_JMP_RUN(comparator) { \
+    int immediate = 0; \
+    int dest = 0; \
+    memcpy(&immediate, ARG_PTR, sizeof(immediate)); \
+    memcpy(&dest, ARG_PTR + sizeof(immediate), sizeof(dest)); \
+ \
+    _LOG_FAIL_CHECK_(dest != 0, "error", ERROR_REPORTS, { \
+        log_printf(ERROR_REPORTS, "error", "JMPG argument was 0, terminating.\n"); \
+    }, ERRNO, EFAULT); \
+ \
+    GET_TOP(stack_content_t arg_b); POP_TOP(); \
+ \
+    if (immediate comparator arg_b) SHIFT = dest; \
+}
+
+#define __IMM_JMP_DISASM { \
+    int immediate = 0; \
+    int dest = 0; \
+    memcpy(&immediate, ARG_PTR, sizeof(immediate)); \
+    memcpy(&dest, ARG_PTR + sizeof(immediate), sizeof(dest)); \
+ \
+    fprintf(OUT_FILE, "%d ", immediate); \
+    PRINT_TARGET(dest); \
+}
+
+//* Jump distance is always the last argument of a branch.
+#define __IMM_JMP_META CMD_META(2 * sizeof(int), 1, 0, CMD_F_BRANCH | CMD_F_COND)
+
+DEF_CMD(JMPGI,  __IMM_JMP_META, __IMM_JMP_ASM, __IMM_JMP_RUN( >), __IMM_JMP_DISASM)
+DEF_CMD(JMPLI,  __IMM_JMP_META, __IMM_JMP_ASM, __IMM_JMP_RUN( <), __IMM_JMP_DISASM)
+DEF_CMD(JMPEI,  __IMM_JMP_META, __IMM_JMP_ASM, __IMM_JMP_RUN(==), __IMM_JMP_DISASM)
+DEF_CMD(JMPGEI, __IMM_JMP_META, __IMM_JMP_ASM, __IMM_JMP_RUN(>=), __IMM_JMP_DISASM)
+DEF_CMD(JMPLEI, __IMM_JMP_META, __IMM_JMP_ASM, __IMM_JMP_RUN(<=), __IMM_JMP_DISASM)
+
+#undef __IMM_META
+#undef __IMM_ASM
+#undef __IMM_OPERATION
+#undef __IMM_DISASM
+#undef __IMM_JMP_META
+#undef __IMM_JMP_ASM
+#undef __IMM_JMP_RUN
+#undef __IMM_JMP_DISASM
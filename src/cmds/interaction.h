@@ -1,23 +1,26 @@
-DEF_CMD(OUTC, {}, {
+DEF_CMD(OUTC, CMD_META(0, 1, 1, CMD_F_IO), {}, {
     _LOG_EMPT_STACK_(COMMAND_NAME);
-    putc((int)stack_get(STACK, ERRNO), stdout);
+    console_put_char((char)stack_get(STACK, ERRNO));
 }, {})
 
-DEF_CMD(OUT, {}, {
+DEF_CMD(OUT, CMD_META(0, 1, 1, CMD_F_IO), {}, {
     _LOG_EMPT_STACK_(COMMAND_NAME);
-    printf("%lld", stack_get(STACK, ERRNO));
+    console_put_int(stack_get(STACK, ERRNO));
 }, {})
 
-DEF_CMD(CCLR, {}, {
-    clear_console(); //* Defined in processor.cpp
+DEF_CMD(CCLR, CMD_META(0, 0, 0, CMD_F_IO), {}, {
+    console_flush();
+    clear_console(); //* Defined in cmd_executor.cpp
 }, {})
 
-DEF_CMD(DRAW, {}, {
-    draw_vmd(&VMD); //* Defined in processor.cpp
+DEF_CMD(DRAW, CMD_META(0, 0, 0, CMD_F_IO), {}, {
+    draw_vmd(&VMD); //* Defined in cmd_executor.cpp
+    console_flush();
 }, {})
 
-DEF_CMD(IN, {}, {
+DEF_CMD(IN, CMD_META(0, 0, 1, CMD_F_IO), {}, {
     int input = 0;
+    console_flush();
     scanf("%d", &input);
     PUSH(input);
 }, {})
\ No newline at end of file
@@ -1,7 +1,16 @@
-DEF_CMD(PUSH, {
+DEF_CMD(PUSH, CMD_META(sizeof(int), 0, 1, CMD_F_MASKED), {
+    check_register_name(ARG_PTR, ERRNO);
     PPArgument arg = read_pparg(ARG_PTR);
-    BUF_WRITE(&arg.value, sizeof(arg.value));
-    BUF_PTR[0] |= arg.props;
+    double real = 0;
+    //* Fractional and exponent literals are pushed as doubles (see floats.h).
+    if (arg.props == 0 && read_float(ARG_PTR, &real) > arg.length) {
+        BUF_PTR[0] = (char)(CMD_PUSHF << 2);
+        BUF_WRITE(&real, sizeof(real));
+    } else {
+        BUF_WRITE(&arg.value, sizeof(arg.value));
+        BUF_PTR[0] |= arg.props;
+        BUF_PTR[1] = (char)arg.reg;
+    }
     log_printf(STATUS_REPORTS, "status", "Parser decided on the value = %d, properties = %d.\n", arg.value, arg.props);
 }, {
     int arg = 0;
@@ -10,32 +19,30 @@ DEF_CMD(PUSH, {
                             /* ^ first two bits */
     log_printf(STATUS_REPORTS, "status", "Argument = %d, command mask = %d.\n", arg, usage);
     int status = 0;
-    int* subject = link_argument(usage, &arg, RAM, REG, &status);
+    int* subject = link_argument(usage, (unsigned char)EXEC_POINT[1], &arg, RAM, REG, &status);
     if (status) {
         SHIFT = 0;
         log_printf(ERROR_REPORTS, "error", "Failed to link command argument at %0*X.\n", sizeof(void*), EXEC_POINT);
-    } else {
-        PUSH(*subject);
-        SHIFT += (int)sizeof(arg);
-    }
+    } else PUSH(*subject);
 }, {
     int arg = 0;
     memcpy(&arg, ARG_PTR, sizeof(arg));
     char usage = *EXEC_POINT & 3;
                             /* ^ first two bits */
     log_printf(STATUS_REPORTS, "status", "Argument = %d, command mask = %d.\n", arg, usage);
-    write_argument(OUT_FILE, usage, arg);
-    SHIFT += (int)sizeof(arg);
+    write_argument(OUT_FILE, usage, (unsigned char)EXEC_POINT[1], arg);
 })
 
-DEF_CMD(POP, {}, {
+DEF_CMD(POP, CMD_META(0, 1, 0, 0), {}, {
     POP_TOP();
 }, {})
 
-DEF_CMD(MOVE, {
+DEF_CMD(MOVE, CMD_META(sizeof(int), 1, 0, CMD_F_MASKED), {
+    check_register_name(ARG_PTR, ERRNO);
     PPArgument arg = read_pparg(ARG_PTR);
     BUF_WRITE(&arg.value, sizeof(arg.value));
     BUF_PTR[0] |= arg.props;
+    BUF_PTR[1] = (char)arg.reg;
     log_printf(STATUS_REPORTS, "status", "Parser decided on value = %d, properties = %d.\n", arg.value, arg.props);
 }, {
     _LOG_EMPT_STACK_("MOVE");
@@ -45,14 +52,17 @@ DEF_CMD(MOVE, {
                             /* ^ first two bits */
     log_printf(STATUS_REPORTS, "status", "Argument = %d, command mask = %d.\n", arg, usage);
     int status = 0;
-    int* subject = link_argument(usage, &arg, RAM, REG, &status);
+    int* subject = link_argument(usage, (unsigned char)EXEC_POINT[1], &arg, RAM, REG, &status);
     if (status) {
         SHIFT = 0;
         log_printf(ERROR_REPORTS, "error", "Failed to link command argument at %0*X.\n", sizeof(void*), EXEC_POINT);
     } else {
         GET_TOP(stack_content_t value); POP_TOP();
-        *subject = (int)value;
-        SHIFT += (int)sizeof(arg);
+        _LOG_FAIL_CHECK_(fits_cell(value), "error", ERROR_REPORTS, {
+            log_printf(ERROR_REPORTS, "error", "Value %lld does not fit into a memory cell at %0*X.\n", value, sizeof(void*), EXEC_POINT);
+            SHIFT = 0;
+        }, ERRNO, ERANGE);
+        if (fits_cell(value)) *subject = (int)value;
     }
 }, {
     int arg = 0;
@@ -60,26 +70,29 @@ DEF_CMD(MOVE, {
     char usage = *EXEC_POINT & 3;
                             /* ^ first two bits */
     log_printf(STATUS_REPORTS, "status", "Argument = %d, command mask = %d.\n", arg, usage);
-    write_argument(OUT_FILE, usage, arg);
-    SHIFT += (int)sizeof(arg);
+    write_argument(OUT_FILE, usage, (unsigned char)EXEC_POINT[1], arg);
 })
 
-DEF_CMD(DUP, {}, {
+DEF_CMD(DUP, CMD_META(0, 1, 2, 0), {}, {
     GET_TOP(stack_content_t value);
-    PUSH((int)value);
+    PUSH(value);
 }, {})
 
-DEF_CMD(VSET, {}, {
+DEF_CMD(VSET, CMD_META(0, 2, 1, 0), {}, {
     GET_TOP(stack_content_t key); POP_TOP();
     GET_TOP(stack_content_t value);
     _LOG_FAIL_CHECK_(0 <= key && key < (stack_content_t)VMD_SIZE, "error", ERROR_REPORTS, {
         log_printf(ERROR_REPORTS, "error", "Incorrect memory index of %d was specified in MSET at %0*X.\n", key, sizeof(void*), EXEC_POINT);
         SHIFT = 0;
     }, ERRNO, EFAULT);
-    VMD.content[key] = (int)value;
+    _LOG_FAIL_CHECK_(fits_cell(value), "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Value %lld does not fit into a VMD cell at %0*X.\n", value, sizeof(void*), EXEC_POINT);
+        SHIFT = 0;
+    }, ERRNO, ERANGE);
+    if (SHIFT) VMD.content[key] = (int)value;
 }, {})
 
-DEF_CMD(VGET, {}, {
+DEF_CMD(VGET, CMD_META(0, 1, 1, 0), {}, {
     GET_TOP(stack_content_t key); POP_TOP();
     _LOG_FAIL_CHECK_(0 <= key && key < (stack_content_t)VMD_SIZE, "error", ERROR_REPORTS, {
         log_printf(ERROR_REPORTS, "error", "Incorrect memory index of %d was specified in VGET at %0*X.\n", key, sizeof(void*), EXEC_POINT);
@@ -0,0 +1,23 @@
+//* CALLN name calls a function implemented by the processor (see natdef.h), the assembler stores its id.
+
+DEF_CMD(CALLN, CMD_META(sizeof(int), 0, 0, 0), {
+    char name[LABEL_MAX_NAME_LENGTH] = "";
+    sscanf(ARG_PTR, " %127s", name);
+    int native_id = find_native(name);
+    _LOG_FAIL_CHECK_(native_id >= 0, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Unknown native function \"%s\".\n", name);
+    }, ERRNO, EINVAL);
+    BUF_WRITE(&native_id, sizeof(native_id));
+}, {
+    unsigned int native_id = 0;
+    memcpy(&native_id, ARG_PTR, sizeof(native_id));
+    if (!call_native(native_id, STACK, &RAM, &REG, ERRNO)) {
+        SHIFT = 0;
+        log_printf(ERROR_REPORTS, "error", "Native function call failed at %0*X.\n", sizeof(void*), EXEC_POINT);
+    }
+}, {
+    unsigned int native_id = 0;
+    memcpy(&native_id, ARG_PTR, sizeof(native_id));
+    if (native_id < NATIVE_COUNT) fprintf(OUT_FILE, "%s", NATIVE_INFO[native_id].name);
+    else fprintf(OUT_FILE, "%u", native_id);
+})
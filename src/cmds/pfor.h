@@ -0,0 +1,75 @@
+//* PFOR counter, begin, end, label calls the subroutine at the label for every index of [begin, end) on the worker pool.
+//* Counter is a register, begin and end are PUSH-like arguments (PFOR RCX, 0, [1], column).
+//* Every call has its own stacks and a copy of the registers with the counter set to the index, the body ends with RET.
+//* Argument is {bounds usage, begin, end, distance}, bounds usage is {begin usage, begin register, end usage, end register}.
+
+#define __PFOR_WRITE_BOUND(usage, reg_id, value) \
+    if (usage) write_argument(OUT_FILE, (char)(usage), reg_id, value); \
+    else fprintf(OUT_FILE, "%d", value);
+
+DEF_CMD(PFOR, CMD_META(4 * sizeof(int), 0, 0, CMD_F_MASKED | CMD_F_BRANCH | CMD_F_CALL), {
+    check_register_name(ARG_PTR, ERRNO);
+    PPArgument counter = read_pparg(ARG_PTR);
+    _LOG_FAIL_CHECK_(counter.props == USE_REGISTER, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "PFOR counter should be a register.\n");
+    }, ERRNO, EINVAL);
+
+    const char* begin_ptr = ARG_PTR + counter.length;
+    begin_ptr += strspn(begin_ptr, " \t,");
+    check_register_name(begin_ptr, ERRNO);
+    PPArgument begin = read_pparg(begin_ptr);
+
+    const char* end_ptr = begin_ptr + begin.length;
+    end_ptr += strspn(end_ptr, " \t,");
+    check_register_name(end_ptr, ERRNO);
+    PPArgument end = read_pparg(end_ptr);
+
+    const char* lbl_ptr = end_ptr + end.length;
+    lbl_ptr += strspn(lbl_ptr, " \t,");
+
+    unsigned char bounds[sizeof(int)] = {};
+    bounds[0] = (unsigned char)begin.props;
+    bounds[1] = begin.reg;
+    bounds[2] = (unsigned char)end.props;
+    bounds[3] = end.reg;
+
+    int operands[4] = {};
+    memcpy(&operands[0], bounds, sizeof(bounds));
+    operands[1] = begin.value;
+    operands[2] = end.value;
+    operands[3] = GET_DISTANCE(lbl_ptr);
+
+    BUF_WRITE(operands, sizeof(operands));
+    BUF_PTR[0] |= counter.props;
+    BUF_PTR[1] = (char)counter.reg;
+}, {
+    int operands[4] = {};
+    memcpy(operands, ARG_PTR, sizeof(operands));
+    unsigned char bounds[sizeof(int)] = {};
+    memcpy(bounds, &operands[0], sizeof(bounds));
+
+    int status = 0;
+    int* begin = link_argument((char)bounds[0], bounds[1], &operands[1], RAM, REG, &status);
+    int* end = status ? NULL : link_argument((char)bounds[2], bounds[3], &operands[2], RAM, REG, &status);
+
+    if (status || !thread_parallel_for(EXEC_POINT, EXEC_POINT + operands[3], (unsigned char)EXEC_POINT[1], *begin, *end,
+                                       &REG, &RAM, &VMD, ERRNO)) {
+        SHIFT = 0;
+        log_printf(ERROR_REPORTS, "error", "PFOR failed at %0*X.\n", sizeof(void*), EXEC_POINT);
+    }
+}, {
+    int operands[4] = {};
+    memcpy(operands, ARG_PTR, sizeof(operands));
+    unsigned char bounds[sizeof(int)] = {};
+    memcpy(bounds, &operands[0], sizeof(bounds));
+
+    write_register(OUT_FILE, (unsigned char)EXEC_POINT[1]);
+    fputs(", ", OUT_FILE);
+    __PFOR_WRITE_BOUND(bounds[0], bounds[1], operands[1]);
+    fputs(", ", OUT_FILE);
+    __PFOR_WRITE_BOUND(bounds[2], bounds[3], operands[2]);
+    fputs(", ", OUT_FILE);
+    PRINT_TARGET(operands[3]);
+})
+
+#undef __PFOR_WRITE_BOUND
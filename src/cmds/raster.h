@@ -0,0 +1,54 @@
+//* Raster commands draw whole rectangles into the video memory, their operands are registers.
+//* VRECT x y w h value, VFILL value, VHLINE x y w value and VBLIT x y w h source share one opcode.
+//* Argument is {variant, operand registers...}, rectangles are clipped against the screen once per command.
+
+#define __RASTER_OPERAND_COUNT(variant) ((variant) == 1 ? 1 : (variant) == 2 ? 4 : 5)
+
+DEF_CMD(VRECT, CMD_META(2 * sizeof(int), 0, 0, CMD_F_VARIANT), {
+    unsigned char operands[2 * sizeof(int)] = {};
+    operands[0] = VARIANT;
+    int count = __RASTER_OPERAND_COUNT(VARIANT);
+    _LOG_FAIL_CHECK_(read_registers(ARG_PTR, operands + 1, count, ERRNO) == count, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Raster command takes %d registers as operands.\n", count);
+    }, ERRNO, EINVAL);
+    BUF_WRITE(operands, sizeof(operands));
+}, {
+    unsigned char operands[2 * sizeof(int)] = {};
+    memcpy(operands, ARG_PTR, sizeof(operands));
+    int values[5] = {};
+    int status = 0;
+    for (int id = 0; id < __RASTER_OPERAND_COUNT(operands[0]) && !status; ++id) {
+        int* operand = link_argument(USE_REGISTER, operands[id + 1], NULL, RAM, REG, &status);
+        if (!status) values[id] = *operand;
+    }
+    if (!status) switch (operands[0]) {
+        case 0: vmd_fill_rect(&VMD, values[0], values[1], values[2], values[3], values[4]); break;
+        case 1: mem_fill(VMD.content, VMD_SIZE, values[0]); break;
+        case 2: vmd_fill_rect(&VMD, values[0], values[1], values[2], 1, values[3]); break;
+        case 3: {
+            long long cells = (long long)values[2] * values[3];
+            if (values[2] <= 0 || values[3] <= 0) break;
+            const int* source = cells > (long long)RAM.size ? NULL : link_ram_range(RAM, values[4], (int)cells, &status);
+            if (source) vmd_blit(&VMD, values[0], values[1], values[2], values[3], source);
+            else status = EFAULT;
+        } break;
+        default: status = EINVAL;
+    }
+    if (status) {
+        SHIFT = 0;
+        log_printf(ERROR_REPORTS, "error", "Invalid operands of %s at %0*X.\n", cmd_name(EXEC_POINT), sizeof(void*), EXEC_POINT);
+    }
+}, {
+    unsigned char operands[2 * sizeof(int)] = {};
+    memcpy(operands, ARG_PTR, sizeof(operands));
+    for (int id = 0; id < __RASTER_OPERAND_COUNT(operands[0]); ++id) {
+        if (id) fputc(' ', OUT_FILE);
+        write_register(OUT_FILE, operands[id + 1]);
+    }
+})
+
+DEF_ALIAS(VFILL,  VRECT, 1, CMD_META(2 * sizeof(int), 0, 0, CMD_F_VARIANT))
+DEF_ALIAS(VHLINE, VRECT, 2, CMD_META(2 * sizeof(int), 0, 0, CMD_F_VARIANT))
+DEF_ALIAS(VBLIT,  VRECT, 3, CMD_META(2 * sizeof(int), 0, 0, CMD_F_VARIANT))
+
+#undef __RASTER_OPERAND_COUNT
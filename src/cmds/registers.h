@@ -0,0 +1,46 @@
+//* Register-direct arithmetic, ADDR RAX RBX RCX puts RBX + RCX into RAX without touching the stack.
+//* ADD, SUB, MUL and DIV written with register operands are encoded as these commands.
+
+#define __REG_OPERATION_ASM { \
+    unsigned char regs[sizeof(int)] = {}; \
+    _LOG_FAIL_CHECK_(read_register_operands(ARG_PTR, regs, ERRNO), "error", ERROR_REPORTS, {}, ERRNO, EINVAL); \
+    BUF_WRITE(regs, sizeof(regs)); \
+}
+
+#define __REG_OPERATION(operation) { \
+    unsigned char regs[sizeof(int)] = {}; \
+    memcpy(regs, ARG_PTR, sizeof(regs)); \
+    int status = 0; \
+    int* dest   = link_argument(USE_REGISTER, regs[0], NULL, RAM, REG, &status); \
+    int* first  = link_argument(USE_REGISTER, regs[1], NULL, RAM, REG, &status); \
+    int* second = link_argument(USE_REGISTER, regs[2], NULL, RAM, REG, &status); \
+    if (status) { \
+        SHIFT = 0; \
+        log_printf(ERROR_REPORTS, "error", "Failed to link command argument at %0*X.\n", sizeof(void*), EXEC_POINT); \
+    } else *dest = *first operation *second; \
+}
+
+#define __REG_OPERATION_DISASM { \
+    unsigned char regs[sizeof(int)] = {}; \
+    memcpy(regs, ARG_PTR, sizeof(regs)); \
+    write_register(OUT_FILE, regs[0]); \
+    fputc(' ', OUT_FILE); \
+    write_register(OUT_FILE, regs[1]); \
+    fputc(' ', OUT_FILE); \
+    write_register(OUT_FILE, regs[2]); \
+}
+
+#define __REG_OPERATION_META CMD_META(sizeof(int), 0, 0, 0)
+
+DEF_CMD(ADDR, __REG_OPERATION_META, __REG_OPERATION_ASM, __REG_OPERATION(+), __REG_OPERATION_DISASM)
+
+DEF_CMD(SUBR, __REG_OPERATION_META, __REG_OPERATION_ASM, __REG_OPERATION(-), __REG_OPERATION_DISASM)
+
+DEF_CMD(MULR, __REG_OPERATION_META, __REG_OPERATION_ASM, __REG_OPERATION(*), __REG_OPERATION_DISASM)
+
+DEF_CMD(DIVR, __REG_OPERATION_META, __REG_OPERATION_ASM, __REG_OPERATION(/), __REG_OPERATION_DISASM)
+
+#undef __REG_OPERATION_META
+#undef __REG_OPERATION_ASM
+#undef __REG_OPERATION
+#undef __REG_OPERATION_DISASM
@@ -0,0 +1,46 @@
+//* OUTS start[, count] prints count RAM cells starting at start as characters, without count it stops at the cell with 0.
+//* Start is a PUSH-like argument: OUTS 100, OUTS RAX or OUTS [RBX+2] (then the start index is read from RAM).
+//* Argument is {start, count}, count of -1 means the string ends with 0.
+
+DEF_CMD(OUTS, CMD_META(2 * sizeof(int), 0, 0, CMD_F_MASKED | CMD_F_IO), {
+    check_register_name(ARG_PTR, ERRNO);
+    PPArgument arg = read_pparg(ARG_PTR);
+    int operands[2] = {};
+    operands[0] = arg.value;
+    operands[1] = -1;
+    const char* count_ptr = ARG_PTR + arg.length;
+    count_ptr += strspn(count_ptr, " \t,");
+    if (*count_ptr != '\0') {
+        read_immediate(count_ptr, &operands[1], ERRNO);
+        _LOG_FAIL_CHECK_(operands[1] >= 0, "error", ERROR_REPORTS, {
+            log_printf(ERROR_REPORTS, "error", "OUTS can not print %d characters.\n", operands[1]);
+        }, ERRNO, EINVAL);
+    }
+    BUF_WRITE(operands, sizeof(operands));
+    BUF_PTR[0] |= arg.props;
+    BUF_PTR[1] = (char)arg.reg;
+}, {
+    int operands[2] = {};
+    memcpy(operands, ARG_PTR, sizeof(operands));
+    char usage = *EXEC_POINT & 3;
+    int status = 0;
+    int* start = link_argument(usage, (unsigned char)EXEC_POINT[1], &operands[0], RAM, REG, &status);
+    int count = operands[1];
+    if (!status && count < 0) {
+        count = ram_string_length(RAM, *start, &status);
+    }
+    const int* text = status ? NULL : link_ram_range(RAM, *start, count, &status);
+    if (text) console_put_cells(text, (size_t)count);
+    else {
+        SHIFT = 0;
+        log_printf(ERROR_REPORTS, "error", "Invalid string of %s at %0*X.\n", COMMAND_NAME, sizeof(void*), EXEC_POINT);
+    }
+}, {
+    int operands[2] = {};
+    memcpy(operands, ARG_PTR, sizeof(operands));
+    char usage = *EXEC_POINT & 3;
+    //* write_argument() comments printable immediates, which would hide the count.
+    if (usage) write_argument(OUT_FILE, usage, (unsigned char)EXEC_POINT[1], operands[0]);
+    else fprintf(OUT_FILE, "%d", operands[0]);
+    if (operands[1] >= 0) fprintf(OUT_FILE, ", %d", operands[1]);
+})
@@ -0,0 +1,88 @@
+//* SPAWN label starts a thread at the label and pushes its id, the thread shares RAM and VMD, gets a copy of the registers
+//* and its own stacks and frames, it finishes at END. JOIN removes an id from the stack and waits for that thread.
+//* XADD/XCHG/CAS [cell] are atomic RAM operations, BARRIER n waits until n threads reach a barrier.
+//* JOIN, XADD, XCHG, CAS and BARRIER share one opcode, their argument is {variant, PUSH-like operand}.
+
+DEF_CMD(SPAWN, CMD_META(sizeof(int), 0, 1, CMD_F_BRANCH | CMD_F_CALL), {
+    int argument = GET_DISTANCE(ARG_PTR);
+    BUF_WRITE(&argument, sizeof(argument));
+}, {
+    int dest = 0;
+    memcpy(&dest, ARG_PTR, sizeof(dest));
+    int thread_id = thread_spawn(EXEC_POINT + dest, &REG, &RAM, &VMD, ERRNO);
+    if (thread_id >= 0) PUSH(thread_id);
+    else {
+        SHIFT = 0;
+        log_printf(ERROR_REPORTS, "error", "SPAWN failed at %0*X.\n", sizeof(void*), EXEC_POINT);
+    }
+}, {
+    int dest = 0;
+    memcpy(&dest, ARG_PTR, sizeof(dest));
+    PRINT_TARGET(dest);
+})
+
+DEF_CMD(JOIN, CMD_META(2 * sizeof(int), 1, 0, CMD_F_MASKED | CMD_F_VARIANT), {
+    int operands[2] = {};
+    operands[0] = VARIANT;
+    if (VARIANT != 0) {
+        check_register_name(ARG_PTR, ERRNO);
+        PPArgument arg = read_pparg(ARG_PTR);
+        _LOG_FAIL_CHECK_(VARIANT == 4 || (arg.props & USE_MEMORY), "error", ERROR_REPORTS, {
+            log_printf(ERROR_REPORTS, "error", "Atomic operations only work with RAM cells, \"%s\" is not one.\n", ARG_PTR);
+        }, ERRNO, EINVAL);
+        operands[1] = arg.value;
+        BUF_WRITE(operands, sizeof(operands));
+        BUF_PTR[0] |= arg.props;
+        BUF_PTR[1] = (char)arg.reg;
+    } else BUF_WRITE(operands, sizeof(operands));
+}, {
+    int operands[2] = {};
+    memcpy(operands, ARG_PTR, sizeof(operands));
+    int status = 0;
+    int* cell = operands[0] == 0 ? NULL : link_argument(*EXEC_POINT & 3, (unsigned char)EXEC_POINT[1], &operands[1], RAM, REG, &status);
+    bool success = !status;
+    if (success) switch (operands[0]) {
+        case 0: {
+            GET_TOP(stack_content_t thread_id); POP_TOP();
+            success = thread_join(thread_id, ERRNO);
+        } break;
+        case 1: {
+            GET_TOP(stack_content_t value); POP_TOP();
+            success = fits_cell(value);
+            if (success) PUSH(__atomic_fetch_add(cell, (int)value, __ATOMIC_SEQ_CST));
+        } break;
+        case 2: {
+            GET_TOP(stack_content_t value); POP_TOP();
+            success = fits_cell(value);
+            if (success) PUSH(__atomic_exchange_n(cell, (int)value, __ATOMIC_SEQ_CST));
+        } break;
+        case 3: {
+            GET_TOP(stack_content_t desired); POP_TOP();
+            GET_TOP(stack_content_t expected_value); POP_TOP();
+            int expected = (int)expected_value;
+            success = fits_cell(desired) && fits_cell(expected_value);
+            if (success) PUSH(__atomic_compare_exchange_n(cell, &expected, (int)desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST));
+        } break;
+        case 4: success = thread_barrier(*cell, ERRNO); break;
+        default: {
+            log_printf(ERROR_REPORTS, "error", "Unknown thread operation %d.\n", operands[0]);
+            if (ERRNO) *ERRNO = EINVAL;
+            success = false;
+        }
+    }
+    if (!success) {
+        SHIFT = 0;
+        //* Only operands that do not fit into a RAM cell fail without setting errno.
+        if (ERRNO && !*ERRNO) *ERRNO = ERANGE;
+        log_printf(ERROR_REPORTS, "error", "%s failed at %0*X.\n", cmd_name(EXEC_POINT), sizeof(void*), EXEC_POINT);
+    }
+}, {
+    int operands[2] = {};
+    memcpy(operands, ARG_PTR, sizeof(operands));
+    if (operands[0] != 0) write_argument(OUT_FILE, *EXEC_POINT & 3, (unsigned char)EXEC_POINT[1], operands[1]);
+})
+
+DEF_ALIAS(XADD,    JOIN, 1, CMD_META(2 * sizeof(int), 1, 1, CMD_F_MASKED | CMD_F_VARIANT))
+DEF_ALIAS(XCHG,    JOIN, 2, CMD_META(2 * sizeof(int), 1, 1, CMD_F_MASKED | CMD_F_VARIANT))
+DEF_ALIAS(CAS,     JOIN, 3, CMD_META(2 * sizeof(int), 2, 1, CMD_F_MASKED | CMD_F_VARIANT))
+DEF_ALIAS(BARRIER, JOIN, 4, CMD_META(2 * sizeof(int), 0, 0, CMD_F_MASKED | CMD_F_VARIANT))
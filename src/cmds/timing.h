@@ -0,0 +1,22 @@
+//* TIME pushes the monotonic clock in nanoseconds, SLEEPUNTIL removes a time from the stack and waits for it without spinning.
+//* Both share one opcode, SLEEPUNTIL writes out the console buffer before sleeping.
+
+DEF_CMD(TIME, CMD_META(sizeof(int), 0, 1, CMD_F_VARIANT), {
+    unsigned char selector[sizeof(int)] = { VARIANT };
+    BUF_WRITE(selector, sizeof(selector));
+}, {
+    switch ((unsigned char)*(ARG_PTR)) {
+        case 0: PUSH(timer_now()); break;
+        case 1: {
+            GET_TOP(stack_content_t moment); POP_TOP();
+            console_flush();
+            timer_sleep_until(moment);
+        } break;
+        default: {
+            log_printf(ERROR_REPORTS, "error", "Unknown timing operation %d.\n", (unsigned char)*(ARG_PTR));
+            SHIFT = 0;
+        }
+    }
+}, {})
+
+DEF_ALIAS(SLEEPUNTIL, TIME, 1, CMD_META(sizeof(int), 1, 0, CMD_F_IO | CMD_F_VARIANT))
@@ -17,20 +17,51 @@
 
     // Max byte length of single command. 
     const size_t MAX_CMD_BITE_LENGTH = 128;
+    // Max length of a source line.
+    const size_t MAX_LINE_LENGTH = 1024;
+    // Number of source line characters shown in the listing.
+    const int LISTING_LINE_WIDTH = 36;
+
+    // Minimal number of source lines worth a separate assembly thread.
+    const size_t MIN_CHUNK_LINES = 4096;
+    // Maximal number of assembly threads.
+    const size_t MAX_ASM_THREADS = 64;
 
     // Default name of the output binary file
     #define DEFAULT_BINARY_OUT_NAME "a.bin"
+    // Default name of the output object file
+    #define DEFAULT_OBJECT_OUT_NAME "a.o"
     // Default name of the listing file
     #define DEFAULT_LISTING_NAME "listing.txt"
 
+    // Assembly caches are only valid for the assembler build that created them.
+    static const char BUILD_STAMP[] = __DATE__ " " __TIME__;
+
+#endif
+
+//* LINKER program
+#ifdef LINKER
+
+    // Default name of the linked binary file
+    #define DEFAULT_BINARY_OUT_NAME "a.bin"
+    // Max number of modules linked together.
+    const size_t MAX_LINKED_OBJECTS = 256;
+
 #endif
 
 //* DISASSEMBLER program
-#ifdef DISASM
+#ifdef DISASSEMBLER
 
     // Default name of the disassembler output file.
     const char* DEFAULT_OUTPUT_NAME = "program.txt";
 
+    // Minimal number of code bytes worth a separate disassembly thread.
+    const size_t MIN_CHUNK_BYTES = 64 * 1024;
+    // Maximal number of disassembly threads.
+    const size_t MAX_DISASM_THREADS = 64;
+    // Size of the output file buffer.
+    const size_t OUTPUT_BUFFER_SIZE = 1 << 20;
+
 #endif
 
 //* Processor program
@@ -38,14 +69,29 @@
 
     // Type of BOTH stacks used in processor
     typedef long long stack_content_t;
-    stack_content_t STACK_CONTENT_POISON = (stack_content_t) 0xDEADBABEC0FEBEEF;
+    static const stack_content_t STACK_CONTENT_POISON = (stack_content_t) 0xDEADBABEC0FEBEEF;
 
     static const size_t STACK_START_SIZE = 1024;
     static const size_t ADDR_STACK_START_SIZE = 16;
+    static const size_t FRAME_STACK_START_SIZE = 256;
+    // Maximal number of cells in all local variable frames.
+    static const size_t MAX_FRAME_STACK_SIZE = 1 << 24;
+    // Size of the console output buffer.
+    static const size_t CONSOLE_BUFFER_SIZE = 1 << 15;
+    // Maximal number of threads started by SPAWN that were not joined yet.
+    static const size_t MAX_THREAD_COUNT = 64;
+    // Maximal number of threads executing PFOR loops (including the one that started the loop).
+    static const size_t MAX_PFOR_WORKERS = 64;
 
     // Characters sorted by their brightness
     static const char PIX_STATES[] = R"( .'`^",:;Il!i><~+_-?][}{1)(|\/tfjrxnuvczXYUJCLQ0OZmwqpdbkhao*#MW&8%B@$)";
 
+    // Name of the execution profile file.
+    #define DEFAULT_PROFILE_NAME "profile.txt"
+
+    // Cached program images are only valid for the processor build that verified them.
+    static const char BUILD_STAMP[] = __DATE__ " " __TIME__;
+
 #endif
 
 #endif
\ No newline at end of file
@@ -13,8 +13,9 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
-#include <fcntl.h>
 #include <unistd.h>
+#include <pthread.h>
+#include <time.h>
 
 #include "lib/util/dbg/debug.h"
 #include "lib/util/argparser.h"
@@ -23,6 +24,11 @@
 #include "proccmd.h"
 #include "utils/common.h"
 #include "utils/argworks.h"
+#include "utils/natives.h"
+#include "utils/data_section.h"
+#include "utils/debug_info.h"
+#include "utils/binfile.h"
+#include "utils/control_flow.h"
 
 //* warning: stack protector not protecting function: all local arrays are less than 8 bytes long [-Wstack-protector]
 #pragma GCC diagnostic ignored "-Wstack-protector"
@@ -38,31 +44,120 @@
 void print_label();
 
 /**
- * @brief Read header and check if file matches requirements.
+ * @brief Write information about the program.
  * 
- * @param ptr pointer to the start of the file's content
- * @param output file to write information about the program to
+ * @param program loaded program
+ * @param output file to write to
+ */
+void write_header(const Program* program, FILE* output);
+
+/**
+ * @brief Range of the code disassembled by a single thread.
+ * 
+ * @param content program image
+ * @param begin offset of the first command
+ * @param end offset of the end of the range
+ * @param flow control flow graph
+ * @param debug_info source map (NULL - label names are made up)
+ * @param output file to write to (NULL - write to the buffer)
+ * @param buffer disassembled text
+ * @param buffer_size length of the text
+ * @param status errno of the thread
+ */
+struct DisasmChunk {
+    const char* content = NULL;
+    size_t begin = 0;
+    size_t end = 0;
+    const ControlFlow* flow = NULL;
+    const DebugInfo* debug_info = NULL;
+    FILE* output = NULL;
+    char* buffer = NULL;
+    size_t buffer_size = 0;
+    int status = 0;
+};
+
+/**
+ * @brief Disassemble the code, splitting it into ranges disassembled on separate threads.
+ * 
+ * Ranges start at basic blocks found by the control flow pass, text of every range but the first one
+ * is collected in memory and written after the first range in one piece.
+ * 
+ * @param content program image
+ * @param code_end offset of the end of the code
+ * @param flow control flow graph
+ * @param debug_info source map (NULL - label names are made up)
+ * @param output file to write to
+ * @param thread_count max number of threads to use (0 - number of online processors)
  * @param err_code variable to use as errno
- * @return size_t required pointer shift
  */
-size_t read_header(char* ptr, FILE* output, int* err_code = NULL);
+void disassemble(const char* content, size_t code_end, const ControlFlow* flow, const DebugInfo* debug_info,
+                 FILE* output, size_t thread_count, int* const err_code = NULL);
+
+/**
+ * @brief Disassemble all commands of the range (thread routine).
+ * 
+ * @param chunk_ptr pointer to the DisasmChunk
+ * @return void* NULL
+ */
+void* disassemble_chunk(void* chunk_ptr);
 
 /**
  * @brief Disassemble one command and return pointer shift.
  * 
- * @param ptr pointer to the pointer to the command
- * @param stack stack to operate on
- * @param addr_stack address stack
+ * @param prog_start start of the program image
+ * @param ptr pointer to the command
+ * @param file file to write the command to
+ * @param flow control flow graph used to name jump targets
+ * @param debug_info source map (NULL - label names are made up)
  * @param err_code error code
  * @return size_t
  */
-int process_command(const char* prog_start, const char* ptr, FILE* file, int* const err_code = NULL);
+int process_command(const char* prog_start, const char* ptr, FILE* file, const ControlFlow* flow,
+                    const DebugInfo* debug_info, int* const err_code = NULL);
+
+/**
+ * @brief Print jump target as a label name, or as a distance if it is not a start of a block.
+ * 
+ * @param file file to print to
+ * @param flow control flow graph
+ * @param debug_info source map (NULL - label names are made up)
+ * @param offset offset of the jump command
+ * @param distance jump distance
+ */
+void print_target(FILE* file, const ControlFlow* flow, const DebugInfo* debug_info, size_t offset, int distance);
+
+/**
+ * @brief Write comments and labels preceding the first command of the block.
+ * 
+ * @param file file to write to
+ * @param block block starting at the current command
+ * @param debug_info source map (NULL - label names are made up)
+ */
+void write_block_start(FILE* file, const CodeBlock* block, const DebugInfo* debug_info);
+
+/**
+ * @brief Write data section blocks as DATA directives.
+ * 
+ * @param data start of the data section
+ * @param data_size size of the data section
+ * @param file file to write directives to
+ * @param err_code variable to use as errno
+ */
+void write_data(const char* data, size_t data_size, FILE* file, int* const err_code = NULL);
 
 int main(const int argc, const char** argv) {
     atexit(log_end_program);
 
     // Ignore everything less or equally important as status reports.
     static unsigned int log_threshold = STATUS_REPORTS + 1;
+    //* Source map file name ("" - no labels and line numbers).
+    static char debug_name[1024] = "";
+    static DebugInfo debug_info = {};
+    //* Control flow graph file name ("" - do not write the graph).
+    static char graph_name[1024] = "";
+    static ControlFlow flow = {};
+    //* Number of disassembly threads (0 - number of online processors).
+    static int thread_count = 0;
 
     static const struct ActionTag line_tags[] = {
         #include "cmd_flags/disasm_flags.h"
@@ -97,43 +192,70 @@ int main(const int argc, const char** argv) {
     }, NULL, 0);
 
     track_allocation(&output, (dtor_t*)fclose_var);
+    setvbuf(output, NULL, _IOFBF, OUTPUT_BUFFER_SIZE);
 
-    log_printf(STATUS_REPORTS, "status", "Opening file %s.\n", file_name);
-    int fd = open(file_name, O_RDONLY);
-    _LOG_FAIL_CHECK_(fd != -1, "error", ERROR_REPORTS, {
-        printf("File was not opened, terminating...\n");
+    log_printf(STATUS_REPORTS, "status", "Loading program %s.\n", file_name);
+    static Program program = {};
+    load_program(file_name, &program, &errno);
+    _LOG_FAIL_CHECK_(program.content, "error", ERROR_REPORTS, {
+        printf("File \"%s\" was not loaded, terminating...\n", file_name);
 
         return_clean(EXIT_FAILURE);
 
     }, NULL, 0);
-    track_allocation(&fd, (dtor_t*)close_var);
-    size_t size = flength(fd);
+    track_allocation(&program, (dtor_t*)Program_dtor);
+
+    write_header(&program, output);
+
+    const char* content = program.content;
+
+    if (*debug_name) {
+        log_printf(STATUS_REPORTS, "status", "Loading source map %s...\n", debug_name);
+        read_debug_info(debug_name, &debug_info, &errno);
+        _LOG_FAIL_CHECK_(debug_info.content, "error", ERROR_REPORTS, return_clean(EXIT_FAILURE), NULL, 0);
+        track_allocation(&debug_info, (dtor_t*)DebugInfo_dtor);
+    } else if (program.debug_size) {
+        log_printf(STATUS_REPORTS, "status", "Loading embedded source map...\n");
+        load_debug_info(program.debug, program.debug_size, &debug_info, &errno);
+        _LOG_FAIL_CHECK_(debug_info.content, "error", ERROR_REPORTS, return_clean(EXIT_FAILURE), NULL, 0);
+        track_allocation(&debug_info, (dtor_t*)DebugInfo_dtor);
+    }
 
-    log_printf(STATUS_REPORTS, "status", "Reading file content...\n");
-    char* content = (char*) calloc(size, sizeof(*content));
-    _LOG_FAIL_CHECK_(content, "error", ERROR_REPORTS, {
-        log_printf(ERROR_REPORTS, "error", "Failed to reallocate file content of size %ld, terminating.\n", size);
+    const DebugInfo* source_map = debug_info.content ? &debug_info : NULL;
 
-        return_clean(EXIT_FAILURE);
+    log_printf(STATUS_REPORTS, "status", "Recovering control flow...\n");
+    build_control_flow(content, HEADER_SIZE, program.code_end, &flow, &errno);
+    _LOG_FAIL_CHECK_(flow.block_ids, "error", ERROR_REPORTS, return_clean(EXIT_FAILURE), NULL, 0);
+    track_allocation(&flow, (dtor_t*)ControlFlow_dtor);
+
+    if (*graph_name) {
+        log_printf(STATUS_REPORTS, "status", "Writing control flow graph to %s.\n", graph_name);
+        FILE* graph = fopen(graph_name, "w");
+        _LOG_FAIL_CHECK_(graph, "error", ERROR_REPORTS, {
+            log_printf(ERROR_REPORTS, "error", "Failed to create/open graph file \"%s\", terminating...\n", graph_name);
 
-    }, &errno, ENOMEM);
-    track_allocation(&content, (dtor_t*)free_var);
-    read(fd, content, size);
-    close(fd); fd = 0;
-    untrack_allocation(&fd);
+            return_clean(EXIT_FAILURE);
 
-    char* pointer = content;
+        }, NULL, 0);
 
-    log_printf(STATUS_REPORTS, "status", "Reading file header...\n");
-    size_t prefix_shift = read_header(pointer, output, &errno);
-    pointer += prefix_shift;
-    _LOG_FAIL_CHECK_(prefix_shift, "error", ERROR_REPORTS, return_clean(EXIT_FAILURE), NULL, 0);
+        write_flow_graph(graph, &flow, source_map);
+        fclose(graph);
+    }
 
     log_printf(STATUS_REPORTS, "status", "Starting disassembling commands...\n");
-    int delta = 0;
-    while ((delta = process_command(content, pointer, output, &errno)) != 0) {
-        pointer += delta;
-        if (!(pointer > content && pointer < content + size)) break;
+    struct timespec disasm_start = {}, disasm_end = {};
+    clock_gettime(CLOCK_MONOTONIC, &disasm_start);
+
+    disassemble(content, program.code_end, &flow, source_map, output, thread_count > 0 ? (size_t)thread_count : 0, &errno);
+
+    clock_gettime(CLOCK_MONOTONIC, &disasm_end);
+    printf("Disassembled %lu bytes of code in %.3lf ms.\n", program.code_end - HEADER_SIZE,
+           (double)(disasm_end.tv_sec - disasm_start.tv_sec) * 1e3 +
+           (double)(disasm_end.tv_nsec - disasm_start.tv_nsec) / 1e6);
+
+    if (program.data_size) {
+        log_printf(STATUS_REPORTS, "status", "Writing data section...\n");
+        write_data(program.data, program.data_size, output, &errno);
     }
 
     log_printf(STATUS_REPORTS, "status", "Disassembly complete.\n");
@@ -148,21 +270,143 @@ void print_label() {
     log_printf(ABSOLUTE_IMPORTANCE, "build info", "Build from %s %s.\n", __DATE__, __TIME__);
 }
 
-size_t read_header(char* ptr, FILE* output, int* err_code) {
-    _LOG_FAIL_CHECK_(ptr, "error", ERROR_REPORTS, return 0, err_code, EFAULT);
-    _LOG_FAIL_CHECK_(strncmp(FILE_PREFIX, ptr, PREFIX_SIZE) == 0, "error", ERROR_REPORTS, {
-        log_printf(ERROR_REPORTS, "error", "Wrong file prefix, terminating. Prefix - \"%*s\", expected prefix - \"%*s\"\n",
-                                            PREFIX_SIZE, ptr, PREFIX_SIZE, FILE_PREFIX);
-        return 0;
-    }, err_code, EIO);
-    _LOG_FAIL_CHECK_(*(version_t*)(ptr+4) <= PROC_VERSION, "error", ERROR_REPORTS, {
-        log_printf(ERROR_REPORTS, "error", "Wrong file version, terminating. File version - %d, disassembler version - %d.\n",
-                                                                            *(version_t*)(ptr+4), PROC_VERSION);
-        return 0;
-    }, err_code, EIO);
-    fprintf(output, "# Binary file version: %d\n", *(version_t*)(ptr+4));
+void write_header(const Program* program, FILE* output) {
+    fprintf(output, "# Binary file version: %d\n", program->version);
+    if (program->packed_size) {
+        fprintf(output, "# Packed code: %lu bytes (%lu bytes expanded)\n", program->packed_size,
+                                                                           program->code_end - HEADER_SIZE);
+    }
     fprintf(output, "# Disassembler version: %d\n\n", PROC_VERSION);
-    return HEADER_SIZE;
+}
+
+void disassemble(const char* content, size_t code_end, const ControlFlow* flow, const DebugInfo* debug_info,
+                 FILE* output, size_t thread_count, int* const err_code) {
+    _LOG_FAIL_CHECK_(content && flow && output, "error", ERROR_REPORTS, return, err_code, EFAULT);
+
+    if (thread_count == 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        thread_count = online > 0 ? (size_t)online : 1;
+    }
+
+    size_t chunk_count = (flow->code_end - flow->code_begin + MIN_CHUNK_BYTES - 1) / MIN_CHUNK_BYTES;
+    if (chunk_count > thread_count) chunk_count = thread_count;
+    if (chunk_count > MAX_DISASM_THREADS) chunk_count = MAX_DISASM_THREADS;
+    if (chunk_count == 0) chunk_count = 1;
+
+    DisasmChunk chunks[MAX_DISASM_THREADS] = {};
+
+    //* Ranges are cut at the first block after the even split point, some of them may end up empty.
+    size_t block_id = 0, step = (flow->code_end - flow->code_begin) / chunk_count;
+    for (size_t chunk_id = 0; chunk_id < chunk_count; ++chunk_id) {
+        DisasmChunk* chunk = &chunks[chunk_id];
+        chunk->content = content;
+        chunk->flow = flow;
+        chunk->debug_info = debug_info;
+        chunk->begin = chunk_id ? chunks[chunk_id - 1].end : HEADER_SIZE;
+        chunk->end = code_end;
+
+        if (chunk_id + 1 == chunk_count) break;
+
+        size_t split = flow->code_begin + step * (chunk_id + 1);
+        while (block_id < flow->block_count && flow->blocks[block_id].begin < split) ++block_id;
+        if (block_id < flow->block_count && flow->blocks[block_id].begin > chunk->begin) {
+            chunk->end = flow->blocks[block_id].begin;
+        } else chunk->end = chunk->begin;
+    }
+
+    log_printf(STATUS_REPORTS, "status", "Splitting %lu bytes of code into %lu chunks.\n",
+                                         code_end - HEADER_SIZE, chunk_count);
+
+    pthread_t threads[MAX_DISASM_THREADS] = {};
+    bool spawned[MAX_DISASM_THREADS] = {};
+
+    //* The first chunk is written straight to the output by the calling thread.
+    chunks[0].output = output;
+
+    for (size_t chunk_id = 1; chunk_id < chunk_count; ++chunk_id) {
+        spawned[chunk_id] = pthread_create(&threads[chunk_id], NULL, disassemble_chunk, &chunks[chunk_id]) == 0;
+        if (!spawned[chunk_id]) disassemble_chunk(&chunks[chunk_id]);
+    }
+
+    disassemble_chunk(&chunks[0]);
+
+    int status = chunks[0].status;
+
+    for (size_t chunk_id = 1; chunk_id < chunk_count; ++chunk_id) {
+        if (spawned[chunk_id]) pthread_join(threads[chunk_id], NULL);
+
+        //* Chunks following a failed one are dropped, as disassembly stops at the first unknown command.
+        if (status == 0 && chunks[chunk_id].buffer) fwrite(chunks[chunk_id].buffer, sizeof(char), chunks[chunk_id].buffer_size, output);
+        if (status == 0) status = chunks[chunk_id].status;
+
+        if (chunks[chunk_id].buffer) free(chunks[chunk_id].buffer);
+    }
+
+    if (status && err_code) *err_code = status;
+}
+
+void* disassemble_chunk(void* chunk_ptr) {
+    DisasmChunk* chunk = (DisasmChunk*) chunk_ptr;
+    const DebugInfo* debug_info = chunk->debug_info;
+
+    FILE* output = chunk->output ? chunk->output : open_memstream(&chunk->buffer, &chunk->buffer_size);
+    _LOG_FAIL_CHECK_(output, "error", ERROR_REPORTS, return NULL, &chunk->status, ENOMEM);
+
+    //* Source map labels before the range were either printed by the previous range or do not point at commands.
+    size_t label_id = 0;
+    const DebugLabel* first_label = find_label(debug_info, (uint32_t)chunk->begin);
+    if (first_label) label_id = (size_t)(first_label - debug_info->labels) + (first_label->point < chunk->begin);
+
+    for (size_t offset = chunk->begin; offset < chunk->end;) {
+        const CodeBlock* block = get_block(chunk->flow, offset);
+        if (block) write_block_start(output, block, debug_info);
+
+        for (; debug_info && label_id < debug_info->label_count && debug_info->labels[label_id].point <= offset; ++label_id) {
+            const DebugLabel* label = &debug_info->labels[label_id];
+            if (label->point == offset) fprintf(output, "HERE %.*s\n", (int)label->name_length, label->name);
+        }
+
+        //* Jump targets without source map labels get made up names.
+        const DebugLabel* label = find_label(debug_info, (uint32_t)offset);
+        if (block && (block->jump_target || block->call_target) && !(label && label->point == offset)) {
+            fprintf(output, "%s ", CMD_LABEL);
+            print_block_name(output, block, debug_info);
+            putc('\n', output);
+        }
+
+        int delta = process_command(chunk->content, chunk->content + offset, output, chunk->flow, debug_info, &chunk->status);
+
+        const LineMapping* line = find_line(debug_info, (uint32_t)offset);
+        if (line && line->offset == offset) fprintf(output, "\t# %s:%u", debug_info->source, line->line);
+        putc('\n', output);
+
+        if (delta <= 0) break;
+
+        offset += (size_t)delta;
+    }
+
+    if (!chunk->output) fclose(output);
+
+    return NULL;
+}
+
+void write_block_start(FILE* file, const CodeBlock* block, const DebugInfo* debug_info) {
+    if (block->begin != HEADER_SIZE) putc('\n', file);
+
+    if (!block->reachable) fprintf(file, "# unreachable\n");
+
+    if (block->loop_header) {
+        fprintf(file, "# loop ");
+        print_block_name(file, block, debug_info);
+        fprintf(file, ", depth %lu\n", block->loop_depth);
+    }
+}
+
+void print_target(FILE* file, const ControlFlow* flow, const DebugInfo* debug_info, size_t offset, int distance) {
+    const CodeBlock* block = get_block(flow, (size_t)((long long)offset + distance));
+
+    if (block && (block->jump_target || block->call_target)) print_block_name(file, block, debug_info);
+    else fprintf(file, "%d", distance);
 }
 
 #define _LOG_EMPT_STACK_(command) do {                                                      \
@@ -173,30 +417,32 @@ size_t read_header(char* ptr, FILE* output, int* err_code) {
     }, err_code, EFAULT);                                                                   \
 } while (0)
 
-#define DEF_CMD(name, parse_script, exec_script, disasm_script) \
-case CMD_##name: {fprintf(file, #name " "); disasm_script; putc('\n', file);} break;
+#define DEF_CMD(name, meta, parse_script, exec_script, disasm_script) \
+case CMD_##name: {fprintf(file, "%s ", cmd_name(ptr)); disasm_script;} break;
 
 #define SHIFT shift
 #define EXEC_POINT ptr
-#define ARG_PTR ptr + 1
+#define ARG_PTR ptr + CMD_HEADER_SIZE
 #define ERRNO err_code
 #define OUT_FILE file
+#define PRINT_TARGET(distance) print_target(file, flow, debug_info, (size_t)(ptr - prog_start), distance)
 
-int process_command(const char* prog_start, const char* ptr, FILE* file, int* const err_code) {
+int process_command(const char* prog_start, const char* ptr, FILE* file, const ControlFlow* flow,
+                    const DebugInfo* debug_info, int* const err_code) {
     _LOG_FAIL_CHECK_(ptr, "error", ERROR_REPORTS, return 0, err_code, EFAULT);
 
     log_printf(STATUS_REPORTS, "status", "Executing command %02X (mask %d) at 0x%0*X.\n", 
-               (*ptr >> 2) & 0xFF, *ptr & 3, sizeof(prog_start), ptr - prog_start);
+               ((unsigned char)*ptr >> 2), *ptr & 3, sizeof(prog_start), ptr - prog_start);
     
     _LOG_FAIL_CHECK_(file, "error", ERROR_REPORTS, return 0, err_code, EFAULT);
 
-    int shift = 1;
+    int shift = cmd_length((unsigned char)*ptr >> 2);
 
-    switch ((*ptr) >> 2) {
+    switch ((unsigned char)*ptr >> 2) {
         #include "cmddef.h"
 
         default:
-            log_printf(ERROR_REPORTS, "error", "Unknown command [%0X]. Terminating.\n", (*ptr) >> 2);
+            log_printf(ERROR_REPORTS, "error", "Unknown command [%0X]. Terminating.\n", (unsigned char)*ptr >> 2);
             if (err_code) *err_code = EIO;
             shift = 0;
         break;
@@ -205,4 +451,38 @@ int process_command(const char* prog_start, const char* ptr, FILE* file, int* co
     return shift;
 }
 
-#undef DEF_CMD
\ No newline at end of file
+#undef DEF_CMD
+
+//* Number of values written in a single DATA directive.
+static const int DATA_VALUES_PER_LINE = 16;
+
+void write_data(const char* data, size_t data_size, FILE* file, int* const err_code) {
+    _LOG_FAIL_CHECK_(file, "error", ERROR_REPORTS, return, err_code, EFAULT);
+
+    const char* end = data + data_size;
+
+    fputc('\n', file);
+
+    while (data < end) {
+        DataBlock block = {};
+        const int* values = (const int*) read_data_block(data, end, &block);
+        _LOG_FAIL_CHECK_(values, "error", ERROR_REPORTS, {
+            log_printf(ERROR_REPORTS, "error", "Data section is corrupt.\n");
+            return;
+        }, err_code, EIO);
+
+        for (int value_id = 0; value_id < block.length; ++value_id) {
+            if (value_id % DATA_VALUES_PER_LINE == 0) {
+                if (value_id) fputc('\n', file);
+                fprintf(file, "DATA %d", block.address + value_id);
+            }
+
+            int value = 0;
+            memcpy(&value, values + value_id, sizeof(value));
+            fprintf(file, " %d", value);
+        }
+        if (block.length) fputc('\n', file);
+
+        data = (const char*)(values + block.length);
+    }
+}
\ No newline at end of file
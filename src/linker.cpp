@@ -0,0 +1,264 @@
+/**
+ * @file linker.cpp
+ * @author Ilya Kudryashov (kudriashov.it@phystech.edu)
+ * @brief Program for merging object files produced by the assembler into a single binary (linker).
+ * @version 0.1
+ * @date 2022-11-05
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lib/util/dbg/debug.h"
+#include "lib/util/argparser.h"
+#include "lib/file_proc.h"
+#include "procinfo.h"
+#include "lib/alloc_tracker/alloc_tracker.h"
+#include "utils/common.h"
+#include "utils/argworks.h"
+#include "utils/labels.h"
+#include "utils/objfile.h"
+#include "utils/binfile.h"
+
+#define LINKER
+
+#include "config.h"
+
+/**
+ * @brief Print program label and build date/time to console and log.
+ *
+ */
+void print_label();
+
+/**
+ * @brief List of loaded modules.
+ *
+ * @param array modules in link order
+ * @param bases offsets of module code from the start of the binary code
+ * @param size number of modules
+ */
+struct ObjectList {
+    ObjectFile array[MAX_LINKED_OBJECTS] = {};
+    size_t bases[MAX_LINKED_OBJECTS] = {};
+    size_t size = 0;
+};
+
+void ObjectList_dtor(ObjectList* list);
+
+/**
+ * @brief Put exported labels of all modules into the label table.
+ *
+ * @param list modules to take labels from
+ * @param labels label table to fill
+ * @param err_code variable to use as errno
+ */
+void collect_symbols(const ObjectList* list, LabelSet* labels, int* const err_code = NULL);
+
+/**
+ * @brief Concatenate module code and fill relocated operands.
+ *
+ * @param list modules to link
+ * @param labels exported labels of all modules
+ * @param code buffer of the size of all module code combined
+ * @param err_code variable to use as errno
+ */
+void link_code(const ObjectList* list, const LabelSet* labels, char* code, int* const err_code = NULL);
+
+/**
+ * @brief Get exported labels of all modules with their offsets in the binary.
+ * 
+ * @param list linked modules
+ * @param symbol_count where to put the number of symbols
+ * @param err_code variable to use as errno
+ * @return ObjSymbol* symbol table (should be freed)
+ */
+ObjSymbol* build_symbol_table(const ObjectList* list, size_t* symbol_count, int* const err_code = NULL);
+
+int main(const int argc, const char** argv) {
+    atexit(log_end_program);
+
+    //* Ignore everything less or equaly important as status reports.
+    static unsigned int log_threshold = STATUS_REPORTS + 1;
+    static LabelSet labels = {};
+    static char out_name[1024] = DEFAULT_BINARY_OUT_NAME;
+
+    ActionTag line_tags[] = {
+        #include "cmd_flags/linker_flags.h"
+    };
+    const int number_of_tags = sizeof(line_tags) / sizeof(*line_tags);
+
+    parse_args(argc, argv, number_of_tags, line_tags);
+    log_init("program_log.log", log_threshold, &errno);
+    print_label();
+
+    LabelSet_ctor(&labels);
+    _LOG_FAIL_CHECK_(labels.array, "error", ERROR_REPORTS, return EXIT_FAILURE, &errno, ENOMEM);
+
+    track_allocation(&labels, (dtor_t*)LabelSet_dtor);
+
+    static ObjectList objects = {};
+    track_allocation(&objects, (dtor_t*)ObjectList_dtor);
+
+    size_t code_size = 0;
+    size_t data_size = 0;
+
+    for (int arg_id = 1; arg_id < argc; ++arg_id) {
+        if (argv[arg_id][0] == '-') continue;
+
+        _LOG_FAIL_CHECK_(objects.size < MAX_LINKED_OBJECTS, "error", ERROR_REPORTS, {
+            log_printf(ERROR_REPORTS, "error", "Can not link more than %lu objects, terminating.\n", MAX_LINKED_OBJECTS);
+
+            return_clean(EXIT_FAILURE);
+
+        }, &errno, E2BIG);
+
+        log_printf(STATUS_REPORTS, "status", "Loading object file %s.\n", argv[arg_id]);
+
+        read_object(argv[arg_id], &objects.array[objects.size], &errno);
+        _LOG_FAIL_CHECK_(objects.array[objects.size].content, "error", ERROR_REPORTS, {
+            printf("Failed to load object file \"%s\", terminating...\n", argv[arg_id]);
+
+            return_clean(EXIT_FAILURE);
+
+        }, NULL, 0);
+
+        objects.bases[objects.size] = code_size;
+        code_size += objects.array[objects.size].code_size;
+        data_size += objects.array[objects.size].data_size;
+        ++objects.size;
+    }
+
+    _LOG_FAIL_CHECK_(objects.size, "error", ERROR_REPORTS, {
+        printf("Object files were not specified, terminating...\n");
+        printf("To link object files run\n%s [object file] [object file] ... -o[binary name]\n", argv[0]);
+
+        return_clean(EXIT_FAILURE);
+
+    }, NULL, 0);
+
+    collect_symbols(&objects, &labels, &errno);
+    _LOG_FAIL_CHECK_(errno == 0, "error", ERROR_REPORTS, return_clean(EXIT_FAILURE), NULL, 0);
+
+    char* code = (char*) calloc(code_size + data_size + 1, sizeof(*code));
+    _LOG_FAIL_CHECK_(code, "error", ERROR_REPORTS, return_clean(EXIT_FAILURE), &errno, ENOMEM);
+    track_allocation(&code, (dtor_t*)free_var);
+
+    link_code(&objects, &labels, code, &errno);
+
+    //* Data blocks of all modules follow the code in link order, so later modules override earlier ones.
+    char* data = code + code_size;
+    for (size_t object_id = 0; object_id < objects.size; ++object_id) {
+        if (objects.array[object_id].data_size == 0) continue;
+
+        memcpy(data, objects.array[object_id].data, objects.array[object_id].data_size);
+        data += objects.array[object_id].data_size;
+    }
+    _LOG_FAIL_CHECK_(errno == 0, "error", ERROR_REPORTS, return_clean(EXIT_FAILURE), NULL, 0);
+
+    log_printf(STATUS_REPORTS, "status", "Opening output file %s.\n", out_name);
+    FILE* output = fopen(out_name, "wb");
+    _LOG_FAIL_CHECK_(output, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Failed to create/open output file \"%s\", terminating...\n", out_name);
+
+        return_clean(EXIT_FAILURE);
+
+    }, NULL, 0);
+
+    track_allocation(&output, (dtor_t*)fclose_var);
+
+    size_t symbol_count = 0;
+    static ObjSymbol* symbols = NULL;
+    symbols = build_symbol_table(&objects, &symbol_count, &errno);
+    _LOG_FAIL_CHECK_(symbols, "error", ERROR_REPORTS, return_clean(EXIT_FAILURE), NULL, 0);
+    track_allocation(&symbols, (dtor_t*)free_var);
+
+    BinSection sections[] = {
+        { SECTION_CODE,    code,                  code_size                            },
+        { SECTION_DATA,    code + code_size,      data_size                            },
+        { SECTION_SYMBOLS, (const char*) symbols, symbol_count * sizeof(*symbols)      },
+    };
+    write_binary(output, sections, sizeof(sections) / sizeof(*sections), &errno);
+
+    printf("Linked %lu objects into %lu bytes of code.\n", objects.size, code_size);
+
+    return_clean(errno == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+void print_label() {
+    printf("Linker for a stack-based processor by Ilya Kudryashov.\n");
+    printf("Program merges object files into a single binary program.\n");
+    printf("Build from\n%s %s\n", __DATE__, __TIME__);
+    log_printf(ABSOLUTE_IMPORTANCE, "build info", "Build from %s %s.\n", __DATE__, __TIME__);
+}
+
+void ObjectList_dtor(ObjectList* list) {
+    for (size_t object_id = 0; object_id < list->size; ++object_id) {
+        ObjectFile_dtor(&list->array[object_id]);
+    }
+    list->size = 0;
+}
+
+void collect_symbols(const ObjectList* list, LabelSet* labels, int* const err_code) {
+    for (size_t object_id = 0; object_id < list->size; ++object_id) {
+        const ObjectFile* object = &list->array[object_id];
+
+        for (size_t symbol_id = 0; symbol_id < object->symbol_count; ++symbol_id) {
+            const ObjSymbol* symbol = &object->symbols[symbol_id];
+
+            _LOG_FAIL_CHECK_(get_label(labels, symbol->hash) == 0, "error", ERROR_REPORTS, {
+                log_printf(ERROR_REPORTS, "error", "Label with hash %llX is exported by more than one object "
+                                                   "(second one is object #%lu).\n", symbol->hash, object_id);
+                return;
+            }, err_code, EINVAL);
+
+            add_label(labels, symbol->hash, HEADER_SIZE + list->bases[object_id] + symbol->point, err_code);
+        }
+    }
+}
+
+void link_code(const ObjectList* list, const LabelSet* labels, char* code, int* const err_code) {
+    for (size_t object_id = 0; object_id < list->size; ++object_id) {
+        const ObjectFile* object = &list->array[object_id];
+        char* module_code = code + list->bases[object_id];
+
+        if (object->code_size) memcpy(module_code, object->code, object->code_size);
+
+        for (size_t reloc_id = 0; reloc_id < object->relocation_count; ++reloc_id) {
+            const ObjRelocation* relocation = &object->relocations[reloc_id];
+
+            uintptr_t target = get_label(labels, relocation->symbol);
+            _LOG_FAIL_CHECK_(target, "error", ERROR_REPORTS, {
+                log_printf(ERROR_REPORTS, "error", "Unresolved label with hash %llX in object #%lu.\n",
+                                                   relocation->symbol, object_id);
+                return;
+            }, err_code, EINVAL);
+
+            int distance = (int)target - (int)(HEADER_SIZE + list->bases[object_id] + relocation->instruction);
+            memcpy(module_code + relocation->operand, &distance, sizeof(distance));
+        }
+    }
+}
+
+ObjSymbol* build_symbol_table(const ObjectList* list, size_t* symbol_count, int* const err_code) {
+    *symbol_count = 0;
+    for (size_t object_id = 0; object_id < list->size; ++object_id) *symbol_count += list->array[object_id].symbol_count;
+
+    ObjSymbol* symbols = (ObjSymbol*) calloc(*symbol_count + 1, sizeof(*symbols));
+    _LOG_FAIL_CHECK_(symbols, "error", ERROR_REPORTS, return NULL, err_code, ENOMEM);
+
+    ObjSymbol* symbol = symbols;
+    for (size_t object_id = 0; object_id < list->size; ++object_id) {
+        const ObjectFile* object = &list->array[object_id];
+
+        for (size_t symbol_id = 0; symbol_id < object->symbol_count; ++symbol_id, ++symbol) {
+            symbol->hash = object->symbols[symbol_id].hash;
+            symbol->point = (uint32_t)(HEADER_SIZE + list->bases[object_id] + object->symbols[symbol_id].point);
+        }
+    }
+
+    return symbols;
+}
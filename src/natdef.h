@@ -0,0 +1,21 @@
+/**
+ * @file natdef.h
+ * @author Ilya Kudryashov (kudriashov.it@phystech.edu)
+ * @brief List of native functions called with CALLN.
+ * @version 0.1
+ * @date 2022-11-14
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+//* DEF_NATIVE(name, pops, pushes), functions are implemented in utils/natives.cpp as native_<name>.
+//* Arguments are taken from the stack in the same order as by ADD (the last element first).
+
+DEF_NATIVE(ABS,   1, 1)     //* x -> |x|
+DEF_NATIVE(ISQRT, 1, 1)     //* x -> floor(sqrt(x))
+DEF_NATIVE(FSIN,  1, 1)     //* x -> sin(x) (floating-point)
+DEF_NATIVE(FCOS,  1, 1)     //* x -> cos(x) (floating-point)
+DEF_NATIVE(FPOW,  2, 1)     //* base, exponent -> base ^ exponent (floating-point)
+DEF_NATIVE(SORT,  2, 0)     //* start, count -> (RAM cells from start are sorted in ascending order)
+DEF_NATIVE(HASH,  2, 1)     //* start, count -> hash of the RAM cells
@@ -19,16 +19,96 @@ static const char CMD_COMMENT_CHAR = '#';
 static const char CMD_LABEL[] = "HERE";
 static hash_t CMD_LABEL_HASH = get_hash(CMD_LABEL, CMD_LABEL + strlen(CMD_LABEL));
 
+//* Directive exporting a label from an object file.
+static const char CMD_GLOBAL[] = "GLOBAL";
+static hash_t CMD_GLOBAL_HASH = get_hash(CMD_GLOBAL, CMD_GLOBAL + strlen(CMD_GLOBAL));
+
+//* Directives putting initial RAM contents into the data section.
+static const char CMD_DATA[] = "DATA";
+static hash_t CMD_DATA_HASH = get_hash(CMD_DATA, CMD_DATA + strlen(CMD_DATA));
+static const char CMD_FILL[] = "FILL";
+static hash_t CMD_FILL_HASH = get_hash(CMD_FILL, CMD_FILL + strlen(CMD_FILL));
+static const char CMD_STRING[] = "STRING";
+static hash_t CMD_STRING_HASH = get_hash(CMD_STRING, CMD_STRING + strlen(CMD_STRING));
+
 static const size_t LABEL_MAX_NAME_LENGTH = 128;
 
-#define DEF_CMD(name, parse_script, exec_script, disasm_script) CMD_##name,
+#define DEF_CMD(name, meta, parse_script, exec_script, disasm_script) CMD_##name,
 
 enum CMD_LIST {
     #include "cmddef.h"
+    CMD_COUNT,
 };
 
 #undef DEF_CMD
-#define DEF_CMD(name, parse_script, exec_script, disasm_script) #name,
+
+//* Opcode byte keeps the command id in its upper 6 bits and the argument usage mask in the lower 2.
+static_assert(CMD_COUNT <= 64, "Command id does not fit into the opcode byte.");
+
+//* Command properties used by the verifier, disassembler and profiler.
+enum CMD_FLAGS {
+    CMD_F_MASKED     = 1 << 0,  //* Command argument can be a register or RAM cell (usage bits are allowed).
+    CMD_F_BRANCH     = 1 << 1,  //* Last 4 bytes of the argument are a relative jump distance.
+    CMD_F_COND       = 1 << 2,  //* Branch may fall through to the next command.
+    CMD_F_CALL       = 1 << 3,  //* Command pushes return address to the address stack.
+    CMD_F_TERMINATOR = 1 << 4,  //* Execution never falls through to the next command.
+    CMD_F_IO         = 1 << 5,  //* Command interacts with the console or the screen.
+    CMD_F_VARIANT    = 1 << 6,  //* First argument byte selects command variant (variants are named with DEF_ALIAS).
+};
+
+/**
+ * @brief Machine-readable description of the command.
+ *
+ * @param name command as it should be written in a source file
+ * @param arg_size number of argument bytes following the opcode
+ * @param pops number of values taken from the stack
+ * @param pushes number of values put onto the stack
+ * @param flags CMD_FLAGS combination
+ */
+struct CmdInfo {
+    const char* name;
+    unsigned char arg_size;
+    unsigned char pops;
+    unsigned char pushes;
+    unsigned int flags;
+};
+
+//* Command metadata as written in DEF_CMD (argument size, stack pops, stack pushes, flags).
+#define CMD_META(arg_size, pops, pushes, flags) arg_size, pops, pushes, flags
+
+#define DEF_CMD(name, meta, parse_script, exec_script, disasm_script) { #name, meta },
+
+//* Command metadata table indexed by command id.
+constexpr CmdInfo CMD_INFO[] = {
+    #include "cmddef.h"
+};
+
+#undef DEF_CMD
+
+//* Command header is {opcode, register id, 2 reserved bytes}, so 4-byte arguments following it are aligned.
+static const int CMD_HEADER_SIZE = 4;
+
+/**
+ * @brief Get full size of the command (header and argument).
+ *
+ * @param cmd_id command id
+ * @return int command size (0 if the command is unknown)
+ */
+constexpr int cmd_length(unsigned int cmd_id) {
+    return cmd_id < CMD_COUNT ? CMD_HEADER_SIZE + CMD_INFO[cmd_id].arg_size : 0;
+}
+
+/**
+ * @brief Get size of the command in version 1 binaries (1-byte opcode followed by the argument).
+ *
+ * @param cmd_id command id
+ * @return int command size (0 if the command is unknown)
+ */
+constexpr int cmd_length_v1(unsigned int cmd_id) {
+    return cmd_id < CMD_COUNT ? 1 + CMD_INFO[cmd_id].arg_size : 0;
+}
+
+#define DEF_CMD(name, meta, parse_script, exec_script, disasm_script) #name,
 
 //* Command as they should be written in a source file.
 static const char* CMD_SOURCE[] = {
@@ -40,6 +120,91 @@ static const char* CMD_SOURCE[] = {
 //* Command hashes.
 static hash_t CMD_HASHES[sizeof(CMD_SOURCE) / sizeof(*CMD_SOURCE)];
 
+/**
+ * @brief Name of the command variant.
+ *
+ * @param name variant as it should be written in a source file
+ * @param cmd_id id of the command implementing the variant
+ * @param variant variant id (first argument byte of the command)
+ * @param arg_size number of argument bytes following the opcode (same as the command has)
+ * @param pops number of values the variant takes from the stack
+ * @param pushes number of values the variant puts onto the stack
+ * @param flags CMD_FLAGS combination of the variant
+ */
+struct CmdAlias {
+    //* Names are stored in place, so the table does not add a string literal per variant.
+    char name[16];
+    unsigned int cmd_id;
+    unsigned char variant;
+    unsigned char arg_size;
+    unsigned char pops;
+    unsigned char pushes;
+    unsigned int flags;
+};
+
+#define DEF_CMD(name, meta, parse_script, exec_script, disasm_script)
+#define DEF_ALIAS(name, command, variant, meta) { #name, CMD_##command, variant, meta },
+
+//* Command variants written under their own names, CMD_INFO describes variant 0.
+constexpr CmdAlias CMD_ALIASES[] = {
+    #include "cmddef.h"
+};
+
+#undef DEF_CMD
+#undef DEF_ALIAS
+
+/**
+ * @brief [DO NOT CALL] Check that every variant belongs to a command with variants and has its argument size.
+ * 
+ * @return true if the variant table is consistent
+ */
+constexpr bool __cmd_check_aliases() {
+    for (const CmdAlias& alias : CMD_ALIASES) {
+        const CmdInfo& command = CMD_INFO[alias.cmd_id];
+        if (!(command.flags & alias.flags & CMD_F_VARIANT) || command.arg_size != alias.arg_size) return false;
+    }
+    return true;
+}
+
+static_assert(__cmd_check_aliases(), "Command variant metadata does not match its command.");
+
+static const size_t CMD_ALIAS_COUNT = sizeof(CMD_ALIASES) / sizeof(*CMD_ALIASES);
+
+//* Command variant hashes.
+static hash_t CMD_ALIAS_HASHES[CMD_ALIAS_COUNT];
+
+/**
+ * @brief Find the variant the command is written as.
+ *
+ * @param command pointer to the command
+ * @return const CmdAlias* variant (NULL if the command is written under its own name)
+ */
+static inline const CmdAlias* cmd_alias(const char* command) {
+    unsigned int cmd_id = (unsigned char)command[0] >> 2;
+    if (cmd_id >= CMD_COUNT || !(CMD_INFO[cmd_id].flags & CMD_F_VARIANT)) return NULL;
+
+    for (size_t alias_id = 0; alias_id < CMD_ALIAS_COUNT; ++alias_id) {
+        if (CMD_ALIASES[alias_id].cmd_id == cmd_id &&
+            CMD_ALIASES[alias_id].variant == (unsigned char)command[CMD_HEADER_SIZE]) return &CMD_ALIASES[alias_id];
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Get name of the command as it should be written in a source file.
+ *
+ * @param command pointer to the command
+ * @return const char* command or variant name
+ */
+static inline const char* cmd_name(const char* command) {
+    unsigned int cmd_id = (unsigned char)command[0] >> 2;
+    if (cmd_id >= CMD_COUNT) return "";
+
+    const CmdAlias* alias = cmd_alias(command);
+    return alias ? alias->name : CMD_INFO[cmd_id].name;
+}
+
 /**
  * @brief [DO NOT CALL] Recalculate CMD_HASHES.
  * 
@@ -54,6 +219,10 @@ static int __cmd_calc_hashes() {
         const char* command = CMD_SOURCE[cmd_id];
         CMD_HASHES[cmd_id] = get_hash(command, command + strlen(command));
     }
+    for (size_t alias_id = 0; alias_id < CMD_ALIAS_COUNT; ++alias_id) {
+        const char* alias = CMD_ALIASES[alias_id].name;
+        CMD_ALIAS_HASHES[alias_id] = get_hash(alias, alias + strlen(alias));
+    }
     return 0;
 }
 
@@ -13,8 +13,6 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
-#include <fcntl.h>
-#include <unistd.h>
 
 #include "lib/util/dbg/debug.h"
 #include "lib/util/argparser.h"
@@ -23,6 +21,12 @@
 #include "proccmd.h"
 #include "utils/common.h"
 #include "utils/argworks.h"
+#include "utils/data_section.h"
+#include "utils/debug_info.h"
+#include "utils/verifier.h"
+#include "utils/binfile.h"
+#include "utils/image_cache.h"
+#include "utils/console.h"
 
 //* warning: stack protector not protecting function: all local arrays are less than 8 bytes long [-Wstack-protector]
 #pragma GCC diagnostic ignored "-Wstack-protector"
@@ -32,6 +36,8 @@
 #include "config.h"
 
 #include "lib/stackworks.h"
+#include "utils/cmd_executor.h"
+#include "utils/vm_threads.h"
 
 /**
  * @brief Print program label and build date/time to console and log.
@@ -40,42 +46,28 @@
 void print_label();
 
 /**
- * @brief Read header and check if file matches requirements.
+ * @brief Execution count of the instruction or the source line.
  * 
- * @param ptr pointer to the start of the file's content
- * @param err_code variable to use as errno
- * @return size_t required pointer shift
+ * @param offset offset of the first instruction
+ * @param count number of executions
  */
-size_t read_header(char* ptr, int* err_code = NULL);
+struct ProfileEntry {
+    uint32_t offset = 0;
+    unsigned long long count = 0;
+};
 
 /**
- * @brief Execute one command and return pointer shift.
- * 
- * @param ptr pointer to the pointer to the command
- * @param stack stack to operate on
- * @param addr_stack address stack
- * @param ram virtual RAM
- * @param reg virtual register
- * @param vmd virtual video memory device
- * @param err_code error code
- * @return size_t
- */
-int execute_command(const char* prog_start, const char* ptr, 
-                    Stack* const stack, Stack* const addr_stack,
-                    MemorySegment* ram, MemorySegment* reg, FrameBuffer* vmd, 
-                    int* const err_code = NULL);
-
-/**
- * @brief Make console empty.
- * 
- */
-void clear_console();
-
-/**
- * @brief Draw picture stored in VMD to the screen with UTF8 characters.
+ * @brief Write execution counts to the file, hottest lines first, followed by the command mix.
  * 
+ * @param content file content
+ * @param counts execution counts of all code offsets
+ * @param size number of code offsets
+ * @param info source map to aggregate counts by source lines (NULL - report every instruction)
+ * @param file_name name of the report file
+ * @param err_code variable to use as errno
  */
-void draw_vmd(FrameBuffer* buffer);
+void write_profile(const char* content, const unsigned long long* counts, size_t size, const DebugInfo* info,
+                   const char* file_name, int* const err_code = NULL);
 
 int main(const int argc, const char** argv) {
     atexit(log_end_program);
@@ -84,7 +76,14 @@ int main(const int argc, const char** argv) {
     unsigned int log_threshold = STATUS_REPORTS + 1;
     FrameBuffer vmd = {};
     MemorySegment ram = {};
-    MemorySegment reg = {}; reg.size = 8;
+    MemorySegment reg = {}; reg.size = MAX_REGISTER_COUNT;
+    //* Source map file name ("" - addresses are reported as is).
+    static char debug_name[1024] = "";
+    static DebugInfo debug_info = {};
+    //* Count instruction executions and write the profile at exit.
+    static int profile = 0;
+    //* Directory of verified program images ("" - do not cache).
+    static char image_cache[1024] = "";
 
     static const struct ActionTag line_tags[] = {
         #include "cmd_flags/processor_flags.h"
@@ -123,23 +122,26 @@ int main(const int argc, const char** argv) {
 
     }, NULL, 0);
 
-    log_printf(STATUS_REPORTS, "status", "Opening file %s.\n", file_name);
-    int fd = open(file_name, O_RDONLY);
-    _LOG_FAIL_CHECK_(fd != -1, "error", ERROR_REPORTS, {
-        printf("File was not opened, terminating...\n");
+    log_printf(STATUS_REPORTS, "status", "Loading program %s.\n", file_name);
+    static Program program = {};
+
+    hash_t build_stamp = get_hash(BUILD_STAMP, BUILD_STAMP + sizeof(BUILD_STAMP));
+    hash_t image_key = *image_cache ? get_image_key(file_name) : 0;
+    bool cached = load_image(image_cache, image_key, build_stamp, &program);
+
+    if (!cached) load_program(file_name, &program, &errno);
+    _LOG_FAIL_CHECK_(program.content, "error", ERROR_REPORTS, {
+        printf("File \"%s\" was not loaded, terminating...\n", file_name);
 
         return_clean(EXIT_FAILURE);
 
     }, NULL, 0);
-    size_t size = flength(fd);
-
-    log_printf(STATUS_REPORTS, "status", "Reading file content...\n");
-    char* content = (char*) calloc(size, sizeof(*content));
-    track_allocation(&content, (dtor_t*)free_var);
-    read(fd, content, size);
-    close(fd);
+    track_allocation(&program, (dtor_t*)Program_dtor);
 
-    char* pointer = content;
+    char* content = program.content;
+    //* Instructions end where the next section starts.
+    size_t size = program.code_end;
+    char* pointer = content + HEADER_SIZE;
 
     log_printf(STATUS_REPORTS, "status", "Initializing stack...\n");
 
@@ -162,14 +164,59 @@ int main(const int argc, const char** argv) {
 
     track_allocation(&addr_stack, (dtor_t*)stack_destroy_void);
 
-    log_printf(STATUS_REPORTS, "status", "Reading file header...\n");
-    size_t prefix_shift = read_header(pointer, &errno);
-    pointer += prefix_shift;
-    _LOG_FAIL_CHECK_(prefix_shift, "error", ERROR_REPORTS, return_clean(EXIT_FAILURE), NULL, 0);
+    FrameStack frames = {};
+    FrameStack_ctor(&frames);
+    _LOG_FAIL_CHECK_(frames.content, "error", ERROR_REPORTS, return_clean(EXIT_FAILURE), &errno, ENOMEM);
+    track_allocation(&frames, (dtor_t*)FrameStack_dtor);
+
+    if (program.data_size) {
+        log_printf(STATUS_REPORTS, "status", "Loading data section...\n");
+        load_data(program.data, program.data_size, &ram, &errno);
+        _LOG_FAIL_CHECK_(errno == 0, "error", ERROR_REPORTS, return_clean(EXIT_FAILURE), NULL, 0);
+    }
+
+    if (!cached) {
+        log_printf(STATUS_REPORTS, "status", "Verifying program code...\n");
+        _LOG_FAIL_CHECK_(verify_code(content, HEADER_SIZE, size, &errno), "error", ERROR_REPORTS, {
+            printf("File \"%s\" does not contain a valid program, terminating...\n", file_name);
+
+            return_clean(EXIT_FAILURE);
+
+        }, NULL, 0);
+
+        save_image(image_cache, image_key, build_stamp, &program);
+    }
+
+    if (*debug_name) {
+        log_printf(STATUS_REPORTS, "status", "Loading source map %s...\n", debug_name);
+        read_debug_info(debug_name, &debug_info, &errno);
+        _LOG_FAIL_CHECK_(debug_info.content, "error", ERROR_REPORTS, return_clean(EXIT_FAILURE), NULL, 0);
+        track_allocation(&debug_info, (dtor_t*)DebugInfo_dtor);
+    } else if (program.debug_size) {
+        log_printf(STATUS_REPORTS, "status", "Loading embedded source map...\n");
+        load_debug_info(program.debug, program.debug_size, &debug_info, &errno);
+        _LOG_FAIL_CHECK_(debug_info.content, "error", ERROR_REPORTS, return_clean(EXIT_FAILURE), NULL, 0);
+        track_allocation(&debug_info, (dtor_t*)DebugInfo_dtor);
+    }
+
+    //* Source map is used if it was either specified or embedded into the binary.
+    const DebugInfo* source_map = debug_info.content ? &debug_info : NULL;
+
+    unsigned long long* exec_counts = NULL;
+    if (profile) {
+        exec_counts = (unsigned long long*) calloc(size + 1, sizeof(*exec_counts));
+        _LOG_FAIL_CHECK_(exec_counts, "error", ERROR_REPORTS, return_clean(EXIT_FAILURE), &errno, ENOMEM);
+        track_allocation(&exec_counts, (dtor_t*)free_var);
+    }
+
+    threads_set_program(content, size);
 
     log_printf(STATUS_REPORTS, "status", "Starting executing commands...\n");
-    int delta = 0;
-    while ((delta = execute_command(content, pointer, &stack, &addr_stack, &ram, &reg, &vmd, &errno)) != 0) {
+    while (true) {
+        if (exec_counts && pointer < content + size) ++exec_counts[pointer - content];
+
+        int delta = execute_command(content, pointer, &stack, &addr_stack, &frames, &ram, &reg, &vmd, &errno);
+        if (delta == 0) break;
 
         char* prev_ptr = pointer;
 
@@ -178,12 +225,29 @@ int main(const int argc, const char** argv) {
         _LOG_FAIL_CHECK_(pointer > content && pointer < content + size, "error", ERROR_REPORTS, {
             log_printf(ERROR_REPORTS, "error", "Invalid pointer value of 0x%0*X after executing command at 0x%0*X. Terminating.\n", 
                                                 sizeof(uintptr_t), pointer - content, sizeof(uintptr_t), prev_ptr - content);
-
-            return_clean(EXIT_FAILURE);
+            pointer = prev_ptr;
+            break;
 
         }, &errno, EFAULT);
     }
 
+    //* Threads that were not joined are waited for, they are stopped if the main thread failed.
+    bool threads_succeeded = thread_join_all(errno != 0);
+    if (!threads_succeeded && !errno) errno = ECHILD;
+
+    console_flush();
+
+    if (errno) {
+        printf("Execution stopped at ");
+        print_location(stdout, source_map, (uint32_t)(pointer - content));
+        printf(".\n");
+    }
+
+    if (exec_counts) {
+        write_profile(content, exec_counts, size, source_map, DEFAULT_PROFILE_NAME);
+        printf("Execution profile was written to %s.\n", DEFAULT_PROFILE_NAME);
+    }
+
     log_printf(STATUS_REPORTS, "status", "Execution finished, cleaning allocated memory...\n");
 
     return_clean(errno ? EXIT_FAILURE : EXIT_SUCCESS);
@@ -196,109 +260,74 @@ void print_label() {
     log_printf(ABSOLUTE_IMPORTANCE, "build info", "Build from %s %s.\n", __DATE__, __TIME__);
 }
 
-size_t read_header(char* ptr, int* err_code) {
-    _LOG_FAIL_CHECK_(ptr, "error", ERROR_REPORTS, return 0, err_code, EFAULT);
-    _LOG_FAIL_CHECK_(strncmp(FILE_PREFIX, ptr, PREFIX_SIZE) == 0, "error", ERROR_REPORTS, {
-        log_printf(ERROR_REPORTS, "error", "Wrong file prefix, terminating. Prefix - \"%*s\", expected prefix - \"%*s\"\n",
-                                            PREFIX_SIZE, ptr, PREFIX_SIZE, FILE_PREFIX);
-        return 0;
-    }, err_code, EIO);
-    _LOG_FAIL_CHECK_(*(version_t*)(ptr+4) <= PROC_VERSION, "error", ERROR_REPORTS, {
-        log_printf(ERROR_REPORTS, "error", "Wrong file version, terminating. File version - %d, processor version - %d.\n",
-                                                                            *(version_t*)(ptr+4), PROC_VERSION);
-        return 0;
-    }, err_code, EIO);
-    return HEADER_SIZE;
+/**
+ * @brief Compare profile entries by execution count (for qsort).
+ * 
+ * @param alpha
+ * @param beta
+ * @return int
+ */
+static int compare_profile_entries(const void* alpha, const void* beta) {
+    unsigned long long count_a = ((const ProfileEntry*)alpha)->count;
+    unsigned long long count_b = ((const ProfileEntry*)beta)->count;
+    return (count_a < count_b) - (count_a > count_b);
 }
 
-#define _LOG_EMPT_STACK_(command) do {                                                      \
-    _LOG_FAIL_CHECK_(stack->size, "error", ERROR_REPORTS, {                                 \
-        log_printf(ERROR_REPORTS, "error", "Request to the empty stack in %s.\n", command); \
-        shift = 0;                                                                          \
-        break;                                                                              \
-    }, err_code, EFAULT);                                                                   \
-} while (0)
-
-#define DEF_CMD(name, parse_script, exec_script, disasm_script) case CMD_##name: { \
-    log_printf(STATUS_REPORTS, "status", "Executing command " #name " (mask %d) at 0x%0*X.\n", \
-                                         *ptr & 3, sizeof(void*), ptr - prog_start); \
-    const char *COMMAND_NAME = #name; \
-    COMMAND_NAME = COMMAND_NAME; \
-    exec_script; \
-} break;
-
-#define STACK           stack
-#define ADDR_STACK      addr_stack
-#define SHIFT           shift
-#define EXEC_POINT      ptr
-#define ARG_PTR         ptr + 1
-#define ERRNO           err_code
-#define REG             ( *reg )
-#define RAM             ( *ram )
-#define VMD_SIZE        (vmd->width * vmd->height)
-#define VMD             ( *vmd )
-#define PUSH(value)     stack_push(STACK, value, ERRNO)
-#define GET_TOP(var)    _LOG_EMPT_STACK_(COMMAND_NAME); var = stack_get(STACK, ERRNO)
-#define POP_TOP()       stack_pop(STACK, ERRNO)
-
-int execute_command(const char* prog_start, const char* ptr,
-                    Stack* const stack, Stack* const addr_stack,
-                    MemorySegment* ram, MemorySegment* reg, FrameBuffer* vmd,
-                    int* const err_code) {
-    _LOG_FAIL_CHECK_(ptr, "error", ERROR_REPORTS, return 0, err_code, EFAULT);
-
-    // log_printf(STATUS_REPORTS, "status", "Executing command %02X (mask %d) at 0x%0*X.\n", 
-    //            (*ptr >> 2) & 0xFF, *ptr & 3, sizeof(prog_start), ptr - prog_start);
-    
-    _LOG_FAIL_CHECK_(stack_status(stack) == 0, "error", ERROR_REPORTS, {
-        log_printf(ERROR_REPORTS, "error", "Memory stack status check failed.\n");
-        stack_dump(stack, ERROR_REPORTS);
-        return 0;
-    }, NULL, 0);
+void write_profile(const char* content, const unsigned long long* counts, size_t size, const DebugInfo* info,
+                   const char* file_name, int* const err_code) {
+    _LOG_FAIL_CHECK_(content && counts && file_name, "error", ERROR_REPORTS, return, err_code, EFAULT);
 
-    _LOG_FAIL_CHECK_(stack_status(addr_stack) == 0, "error", ERROR_REPORTS, {
-        log_printf(ERROR_REPORTS, "error", "Address stack status check failed.\n");
-        stack_dump(addr_stack, ERROR_REPORTS);
-        return 0;
-    }, NULL, 0);
+    ProfileEntry* entries = (ProfileEntry*) calloc(size + 1, sizeof(*entries));
+    _LOG_FAIL_CHECK_(entries, "error", ERROR_REPORTS, return, err_code, ENOMEM);
 
-    int shift = 1;
+    size_t entry_count = 0;
+    unsigned long long total = 0;
+    unsigned long long cmd_counts[CMD_COUNT] = {};
 
-    switch ((*ptr) >> 2) {
-        #include "cmddef.h"
+    for (size_t offset = 0; offset < size; ++offset) {
+        if (counts[offset] == 0) continue;
+        total += counts[offset];
 
-        default:
-            log_printf(ERROR_REPORTS, "error", "Unknown command [%0X]. Terminating.\n", (*ptr) >> 2);
-            if (err_code) *err_code = EIO;
-            shift = 0;
-        break;
-    }
+        unsigned int cmd_id = (unsigned char)content[offset] >> 2;
+        if (cmd_id < CMD_COUNT) cmd_counts[cmd_id] += counts[offset];
 
-    return shift;
-}
+        //* Instructions of the same source line are put together, their lines are sorted by offset.
+        const LineMapping* line = find_line(info, (uint32_t)offset);
+        uint32_t first_offset = line ? line->offset : (uint32_t)offset;
 
-#undef DEF_CMD
+        if (entry_count == 0 || entries[entry_count - 1].offset != first_offset) {
+            entries[entry_count++].offset = first_offset;
+        }
+        entries[entry_count - 1].count += counts[offset];
+    }
 
-#ifdef __linux__
-void clear_console() {
-    system("clear");
-}
-#elif defined(WIN32) || defined(WIN64)
-void clear_console() {
-    system("cls");
-}
-#endif
+    qsort(entries, entry_count, sizeof(*entries), compare_profile_entries);
 
-void draw_vmd(FrameBuffer* buffer) {
-    for (int id_y = 0; id_y < (int)buffer->height; ++id_y) {
-        for (int id_x = 0; id_x < (int)buffer->width; ++id_x) {
+    FILE* output = fopen(file_name, "w");
+    _LOG_FAIL_CHECK_(output, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Failed to create profile file \"%s\".\n", file_name);
+        free(entries);
+        return;
+    }, err_code, ENOENT);
 
-            int brightness = buffer->content[id_y * (int)buffer->width + id_x];
+    fprintf(output, "# %llu instructions executed.\n", total);
+    fprintf(output, "# %18s %7s  %s\n", "executions", "share", "location");
 
-            brightness = clamp(brightness, 0, (int)sizeof(PIX_STATES) - 2);
+    for (size_t entry_id = 0; entry_id < entry_count; ++entry_id) {
+        fprintf(output, "  %18llu %6.2lf%%  ", entries[entry_id].count,
+                (double)entries[entry_id].count * 100.0 / (double)total);
+        print_location(output, info, entries[entry_id].offset);
+        fputc('\n', output);
+    }
 
-            putc(PIX_STATES[brightness], stdout);
-        }
-        putc('\n', stdout);
+    fprintf(output, "\n# %18s %7s  %s\n", "executions", "share", "command");
+
+    for (unsigned int cmd_id = 0; cmd_id < CMD_COUNT; ++cmd_id) {
+        if (cmd_counts[cmd_id] == 0) continue;
+        fprintf(output, "  %18llu %6.2lf%%  %s\n", cmd_counts[cmd_id],
+                (double)cmd_counts[cmd_id] * 100.0 / (double)total, CMD_INFO[cmd_id].name);
     }
-}
\ No newline at end of file
+
+    fclose(output);
+    free(entries);
+}
@@ -9,10 +9,24 @@
  * 
  */
 
+#ifndef PROCINFO_H
+#define PROCINFO_H
+
 #include <stdlib.h>
 
 typedef int version_t;
-const version_t PROC_VERSION = 1;
-const size_t HEADER_SIZE = 16;
+const version_t PROC_VERSION = 2;
 const char FILE_PREFIX[] = "KITy";
-const size_t PREFIX_SIZE = sizeof(FILE_PREFIX) - 1;
\ No newline at end of file
+const size_t PREFIX_SIZE = sizeof(FILE_PREFIX) - 1;
+
+//* Maximum number of entries in the section table (code, data, symbols, debug).
+const size_t MAX_SECTIONS = 4;
+//* File header followed by the section table, code always starts right after it.
+const size_t HEADER_SIZE = 16 + MAX_SECTIONS * 16;
+
+//* Version 1 header (prefix, version, data offset, data size), code follows it directly.
+const size_t V1_HEADER_SIZE = 16;
+const size_t V1_DATA_OFFSET_POS = 8;
+const size_t V1_DATA_SIZE_POS = 12;
+
+#endif
\ No newline at end of file
@@ -7,6 +7,16 @@
 #include "lib/util/dbg/logger.h"
 #include "lib/util/dbg/debug.h"
 
+/**
+ * @brief Check if the number can be a register id.
+ *
+ * @param reg_id number to check
+ * @return true if the register exists in the full register file
+ */
+static inline bool is_register_id(int reg_id) {
+    return 0 <= reg_id && reg_id < (int)MAX_REGISTER_COUNT;
+}
+
 PPArgument read_pparg(const char* arg_ptr) {
     _LOG_FAIL_CHECK_(arg_ptr, "error", ERROR_REPORTS, return (PPArgument){}, NULL, 0);
 
@@ -20,23 +30,47 @@ PPArgument read_pparg(const char* arg_ptr) {
     char buf_id = '\0';
     char op_sign = '\0';
     int value_prev = 0;
+    int reg_id = -1;
 
+    length = 0;
     sscanf(arg_ptr, " [ R%cX %c %d ]%n", &buf_id, &op_sign, &value_prev, &length);
     if (length > max_length) {
         max_length = length;
         if (op_sign == '-') value_prev *= -1;
-        memcpy((char*)&answer.value + 1, &value_prev, sizeof(answer.value) - 1);
-        answer.value |= buf_id - 'A';
+        answer.value = value_prev;
+        answer.reg = (unsigned char)(buf_id - 'A');
+        answer.props = USE_MEMORY | USE_REGISTER;
+    }
+
+    length = 0;
+    sscanf(arg_ptr, " [ R%d %c %d ]%n", &reg_id, &op_sign, &value_prev, &length);
+    if (length > max_length && is_register_id(reg_id)) {
+        max_length = length;
+        if (op_sign == '-') value_prev *= -1;
+        answer.value = value_prev;
+        answer.reg = (unsigned char)reg_id;
         answer.props = USE_MEMORY | USE_REGISTER;
     }
 
+    length = 0;
     sscanf(arg_ptr, " [ R%cX ]%n", &buf_id, &length);
     if (length > max_length) {
         max_length = length;
-        answer.value = buf_id - 'A';
+        answer.value = 0;
+        answer.reg = (unsigned char)(buf_id - 'A');
         answer.props = USE_MEMORY | USE_REGISTER;
     }
 
+    length = 0;
+    sscanf(arg_ptr, " [ R%d ]%n", &reg_id, &length);
+    if (length > max_length && is_register_id(reg_id)) {
+        max_length = length;
+        answer.value = 0;
+        answer.reg = (unsigned char)reg_id;
+        answer.props = USE_MEMORY | USE_REGISTER;
+    }
+
+    length = 0;
     sscanf(arg_ptr, " [ %d ]%n", &value_prev, &length);
     if (length > max_length) {
         max_length = length;
@@ -44,13 +78,25 @@ PPArgument read_pparg(const char* arg_ptr) {
         answer.props = USE_MEMORY;
     }
 
+    length = 0;
     sscanf(arg_ptr, " R%cX%n", &buf_id, &length);
     if (length > max_length) {
         max_length = length;
-        answer.value = buf_id - 'A';
+        answer.value = 0;
+        answer.reg = (unsigned char)(buf_id - 'A');
+        answer.props = USE_REGISTER;
+    }
+
+    length = 0;
+    sscanf(arg_ptr, " R%d%n", &reg_id, &length);
+    if (length > max_length && is_register_id(reg_id)) {
+        max_length = length;
+        answer.value = 0;
+        answer.reg = (unsigned char)reg_id;
         answer.props = USE_REGISTER;
     }
 
+    length = 0;
     sscanf(arg_ptr, " %d%n", &value_prev, &length);
     if (length > max_length) {
         max_length = length;
@@ -58,6 +104,7 @@ PPArgument read_pparg(const char* arg_ptr) {
         answer.props = 0;
     }
 
+    length = 0;
     sscanf(arg_ptr, " \'%c\'%n", &buf_id, &length);
     if (length > max_length) {
         max_length = length;
@@ -65,6 +112,7 @@ PPArgument read_pparg(const char* arg_ptr) {
         answer.props = 0;
     }
 
+    length = 0;
     sscanf(arg_ptr, " \'\\%c\'%n", &buf_id, &length);
     if (length > max_length) {
         max_length = length;
@@ -79,10 +127,103 @@ PPArgument read_pparg(const char* arg_ptr) {
         }
         answer.props = 0;
     }
+    answer.length = max_length;
     return answer;
 }
 
-int* link_argument(char usage, int *arg, MemorySegment ram, MemorySegment reg, int *err_code) {
+bool check_register_name(const char* arg_ptr, int* const err_code) {
+    _LOG_FAIL_CHECK_(arg_ptr, "error", ERROR_REPORTS, return false, err_code, EFAULT);
+
+    const char* name = arg_ptr + strspn(arg_ptr, " \t[");
+    int reg_id = 0, length = 0;
+    sscanf(name, "R%d%n", &reg_id, &length);
+
+    _LOG_FAIL_CHECK_(length == 0 || is_register_id(reg_id), "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Register R%d does not exist, registers are R0 to R%lu.\n",
+                                           reg_id, MAX_REGISTER_COUNT - 1);
+        return false;
+    }, err_code, EINVAL);
+
+    return true;
+}
+
+int read_immediate(const char* arg_ptr, int* value, int* const err_code) {
+    _LOG_FAIL_CHECK_(arg_ptr && value, "error", ERROR_REPORTS, return 0, err_code, EFAULT);
+
+    int length = 0;
+    sscanf(arg_ptr, " %d%n", value, &length);
+
+    _LOG_FAIL_CHECK_(length > 0, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Immediate operand \"%s\" is not an integer.\n", arg_ptr);
+    }, err_code, EINVAL);
+
+    return length;
+}
+
+int read_float(const char* arg_ptr, double* value) {
+    _LOG_FAIL_CHECK_(arg_ptr && value, "error", ERROR_REPORTS, return 0, NULL, EFAULT);
+
+    int length = 0;
+    double result = 0;
+    sscanf(arg_ptr, " %lf%n", &result, &length);
+
+    //* Hexadecimal, infinite and NaN forms accepted by scanf are not literals.
+    for (int id = 0; id < length; ++id) {
+        if (!strchr(" \t+-.eE", arg_ptr[id]) && !isdigit(arg_ptr[id])) return 0;
+    }
+
+    *value = result;
+    return length;
+}
+
+bool read_register_operands(const char* arg_ptr, unsigned char regs[3], int* const err_code) {
+    _LOG_FAIL_CHECK_(arg_ptr && regs, "error", ERROR_REPORTS, return false, err_code, EFAULT);
+
+    int count = read_registers(arg_ptr, regs, 3, err_code);
+    if (count <= 0) return false;
+
+    _LOG_FAIL_CHECK_(count >= 2, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Register-direct commands take two or three registers, got \"%s\".\n", arg_ptr);
+        return false;
+    }, err_code, EINVAL);
+
+    if (count == 2) {
+        regs[2] = regs[1];
+        regs[1] = regs[0];
+    }
+
+    return true;
+}
+
+int read_registers(const char* arg_ptr, unsigned char* regs, int max_count, int* const err_code) {
+    _LOG_FAIL_CHECK_(arg_ptr && regs, "error", ERROR_REPORTS, return -1, err_code, EFAULT);
+
+    int count = 0;
+    const char* ptr = arg_ptr + strspn(arg_ptr, " \t");
+
+    while (*ptr != '\0' && count < max_count) {
+        PPArgument operand = read_pparg(ptr);
+
+        _LOG_FAIL_CHECK_(operand.props == USE_REGISTER, "error", ERROR_REPORTS, {
+            log_printf(ERROR_REPORTS, "error", "Operand \"%s\" is not a register.\n", ptr);
+            return -1;
+        }, err_code, EINVAL);
+
+        regs[count++] = operand.reg;
+
+        ptr += operand.length;
+        ptr += strspn(ptr, " \t,");
+    }
+
+    _LOG_FAIL_CHECK_(*ptr == '\0', "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Too many operands in \"%s\", expected at most %d registers.\n", arg_ptr, max_count);
+        return -1;
+    }, err_code, EINVAL);
+
+    return count;
+}
+
+int* link_argument(char usage, unsigned char reg_id, int *arg, MemorySegment ram, MemorySegment reg, int *err_code) {
     switch (usage) {
         case 0: {
             return arg;
@@ -98,29 +239,23 @@ int* link_argument(char usage, int *arg, MemorySegment ram, MemorySegment reg, i
         } break;
 
         case USE_REGISTER: {
-            _LOG_FAIL_CHECK_(0 <= *arg && *arg < (int)reg.size, "error", ERROR_REPORTS, {
-                log_printf(ERROR_REPORTS, "error", "Incorrect register index of %d.\n", *arg);
+            _LOG_FAIL_CHECK_(reg_id < reg.size, "error", ERROR_REPORTS, {
+                log_printf(ERROR_REPORTS, "error", "Incorrect register index of %d.\n", reg_id);
                 break;
             }, err_code, EFAULT);
 
-            log_printf(STATUS_REPORTS, "status", "Register address = %p.\n", reg.content + *arg);
+            log_printf(STATUS_REPORTS, "status", "Register address = %p.\n", reg.content + reg_id);
 
-            return reg.content + *arg;
+            return reg.content + reg_id;
         } break;
 
         case USE_REGISTER | USE_MEMORY: {
-            int reg_id = *arg & 0xFF;
-
-            int pointer_shift = 0;
-            memcpy(&pointer_shift, (char*)arg + 1, sizeof(pointer_shift) - 1);
-            if (*arg < 0) *((char*)&pointer_shift + sizeof(pointer_shift) - 1) = (char)0xFF;
-
-            _LOG_FAIL_CHECK_(0 <= reg_id && reg_id < (int)reg.size, "error", ERROR_REPORTS, {
+            _LOG_FAIL_CHECK_(reg_id < reg.size, "error", ERROR_REPORTS, {
                 log_printf(ERROR_REPORTS, "error", "Incorrect register index of %d.\n", reg_id);
                 break;
             }, err_code, EFAULT);
 
-            int ram_index = reg.content[reg_id] + pointer_shift;
+            int ram_index = reg.content[reg_id] + *arg;
 
             _LOG_FAIL_CHECK_(0 <= ram_index && ram_index < (int)ram.size, "error", ERROR_REPORTS, {
                 log_printf(ERROR_REPORTS, "error", "Incorrect memory index of %d.\n", ram_index);
@@ -135,7 +270,31 @@ int* link_argument(char usage, int *arg, MemorySegment ram, MemorySegment reg, i
     return NULL;
 }
 
-void write_argument(FILE* dest, char usage, int argument) {
+int* link_ram_range(MemorySegment ram, int start, int count, int* err_code) {
+    _LOG_FAIL_CHECK_(0 <= start && 0 <= count && (size_t)start + (size_t)count <= ram.size, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "RAM range of %d cells at %d does not fit into %lu cells.\n", count, start, ram.size);
+        return NULL;
+    }, err_code, EFAULT);
+
+    return ram.content + start;
+}
+
+int ram_string_length(MemorySegment ram, int start, int* err_code) {
+    _LOG_FAIL_CHECK_(0 <= start && (size_t)start < ram.size, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Incorrect memory index of %d.\n", start);
+        return -1;
+    }, err_code, EFAULT);
+
+    for (size_t id = (size_t)start; id < ram.size; ++id) {
+        if (ram.content[id] == 0) return (int)(id - (size_t)start);
+    }
+
+    log_printf(ERROR_REPORTS, "error", "String at %d does not end before the end of RAM.\n", start);
+    if (err_code) *err_code = EFAULT;
+    return -1;
+}
+
+void write_argument(FILE* dest, char usage, unsigned char reg_id, int argument) {
     switch (usage) {
         case 0: {
             fprintf(dest, "%d", argument);
@@ -149,19 +308,20 @@ void write_argument(FILE* dest, char usage, int argument) {
         } break;
 
         case USE_REGISTER: {
-            fprintf(dest, "R%cX", (char)(argument + 'A'));
+            write_register(dest, reg_id);
         } break;
 
         case USE_REGISTER | USE_MEMORY: {
-            int reg_id = argument & 0xFF;
-
-            int pointer_shift = 0;
-            memcpy(&pointer_shift, (char*)&argument + 1, sizeof(pointer_shift) - 1);
-            if (argument < 0) *((char*)&pointer_shift + sizeof(pointer_shift) - 1) = (char)0xFF;
-
-            fprintf(dest, "[R%cX + %d]", (char)(reg_id + 'A'), pointer_shift);
+            fputc('[', dest);
+            write_register(dest, reg_id);
+            fprintf(dest, " + %d]", argument);
         } break;
 
         default: {log_printf(ERROR_REPORTS, "error", "Usage tag had an unexpected value.\n");}
     }
-}
\ No newline at end of file
+}
+
+void write_register(FILE* dest, unsigned char reg_id) {
+    if (reg_id < NAMED_REGISTER_COUNT) fprintf(dest, "R%cX", (char)(reg_id + 'A'));
+    else fprintf(dest, "R%u", (unsigned int)reg_id);
+}
@@ -14,14 +14,30 @@
 
 #include "common.h"
 
+//* Register ids are stored in a single byte of the command.
+const size_t MAX_REGISTER_COUNT = 256;
+
+//* Registers that have legacy names (RAX, RBX, ...), the rest are written as R8, R9, ...
+const size_t NAMED_REGISTER_COUNT = 8;
+
 enum USAGE_TYPES {
     USE_REGISTER = 1 << 0,
     USE_MEMORY = 1 << 1,
 };
 
+/**
+ * @brief Parsed PUSH/MOVE argument.
+ * 
+ * @param value immediate value, RAM index or RAM offset from the register value
+ * @param props usage tags
+ * @param reg register id (stored in the command header)
+ * @param length number of characters the argument took
+ */
 struct PPArgument {
     int value = 0;
     char props = 0;
+    unsigned char reg = 0;
+    int length = 0;
 };
 
 /**
@@ -32,25 +48,109 @@ struct PPArgument {
  */
 PPArgument read_pparg(const char* arg_ptr);
 
+/**
+ * @brief Check that the argument does not name a register outside of the register file (R256 and above).
+ *
+ * read_pparg() does not take such names as registers, so they should be rejected before it is called.
+ *
+ * @param arg_ptr push/pop argument
+ * @param err_code variable to use as errno
+ * @return true if the argument is not a name of a missing register
+ */
+bool check_register_name(const char* arg_ptr, int* const err_code = NULL);
+
+/**
+ * @brief Extract integer argument of a command with an immediate operand.
+ * 
+ * @param arg_ptr argument
+ * @param value where to put the value
+ * @param err_code variable to use as errno
+ * @return int number of characters read (0 if the argument is not an integer)
+ */
+int read_immediate(const char* arg_ptr, int* value, int* const err_code = NULL);
+
+/**
+ * @brief Extract decimal floating-point literal.
+ * 
+ * @param arg_ptr argument
+ * @param value where to put the value
+ * @return int number of characters read (0 if the argument is not a decimal literal)
+ */
+int read_float(const char* arg_ptr, double* value);
+
+/**
+ * @brief Extract operands of a register-direct command (destination and two sources or destination and source).
+ * 
+ * Operands can be separated with commas. Destination is also the first source if only two operands are given.
+ * 
+ * @param arg_ptr argument
+ * @param regs where to put destination, first source and second source register ids
+ * @param err_code variable to use as errno
+ * @return true if the argument is a valid list of registers (false if it is empty or invalid, err_code is set if invalid)
+ */
+bool read_register_operands(const char* arg_ptr, unsigned char regs[3], int* const err_code = NULL);
+
+/**
+ * @brief Extract list of register operands (operands can be separated with commas).
+ * 
+ * @param arg_ptr argument
+ * @param regs where to put register ids
+ * @param max_count maximal number of registers
+ * @param err_code variable to use as errno
+ * @return int number of registers read (-1 if the argument is not a list of at most max_count registers)
+ */
+int read_registers(const char* arg_ptr, unsigned char* regs, int max_count, int* const err_code = NULL);
+
 /**
  * @brief Get operation subject by usage tags.
  * 
  * @param usage command usage tag
+ * @param reg_id register id from the command header
  * @param arg command argument
  * @param ram RAM memory segment
  * @param reg register
  * @param err_code variable to use as errno
  * @return int* operation subject
  */
-int* link_argument(char usage, int *arg, MemorySegment ram, MemorySegment reg, int *err_code = NULL);
+int* link_argument(char usage, unsigned char reg_id, int *arg, MemorySegment ram, MemorySegment reg, int *err_code = NULL);
+
+/**
+ * @brief Get range of RAM cells, checking its bounds.
+ * 
+ * @param ram RAM memory segment
+ * @param start index of the first cell
+ * @param count number of cells
+ * @param err_code variable to use as errno
+ * @return int* first cell of the range (NULL if the range does not fit into RAM)
+ */
+int* link_ram_range(MemorySegment ram, int start, int count, int* err_code = NULL);
+
+/**
+ * @brief Get length of the string stored in RAM cells (ended by the cell with 0).
+ * 
+ * @param ram RAM memory segment
+ * @param start index of the first character
+ * @param err_code variable to use as errno
+ * @return int number of characters before the end (-1 if there is no end in RAM)
+ */
+int ram_string_length(MemorySegment ram, int start, int* err_code = NULL);
 
 /**
  * @brief Write disassembled argument to file.
  * 
  * @param dest write destination
  * @param usage command usage tag
+ * @param reg_id register id from the command header
  * @param argument command argument
  */
-void write_argument(FILE* dest, char usage, int argument);
+void write_argument(FILE* dest, char usage, unsigned char reg_id, int argument);
+
+/**
+ * @brief Write register name to file.
+ * 
+ * @param dest write destination
+ * @param reg_id register id
+ */
+void write_register(FILE* dest, unsigned char reg_id);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,162 @@
+#include "asm_cache.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "lib/util/dbg/logger.h"
+
+/**
+ * @brief Check if entries describe the same encoding.
+ * 
+ * @param alpha
+ * @param beta
+ * @return true if entries are interchangeable
+ */
+static bool same_entry(const CacheEntry* alpha, const CacheEntry* beta);
+
+/**
+ * @brief Double the capacity of the cache.
+ * 
+ * @param cache
+ * @param err_code variable to use as errno
+ */
+static void cache_grow(AsmCache* cache, int* const err_code);
+
+void AsmCache_ctor(AsmCache* cache, size_t capacity) {
+    size_t real_capacity = 1;
+    while (real_capacity < capacity) real_capacity *= 2;
+
+    cache->entries = (CacheEntry*) calloc(real_capacity, sizeof(*cache->entries));
+    cache->size = 0;
+    cache->capacity = cache->entries ? real_capacity : 0;
+}
+
+void AsmCache_dtor(AsmCache* cache) {
+    if (cache->entries) free(cache->entries);
+    cache->entries = NULL;
+    cache->size = 0;
+    cache->capacity = 0;
+}
+
+hash_t label_env_hash(const LabelSet* labels, const hash_t* deps, size_t dep_count, uintptr_t cur_id) {
+    hash_t distances[MAX_LABEL_DEPS] = {};
+
+    for (size_t dep_id = 0; dep_id < dep_count && dep_id < MAX_LABEL_DEPS; ++dep_id) {
+        distances[dep_id] = (hash_t)(get_label(labels, deps[dep_id]) - cur_id);
+    }
+
+    return get_hash(distances, distances + dep_count);
+}
+
+const CacheEntry* cache_find(const AsmCache* cache, hash_t line_hash, const LabelSet* labels, uintptr_t cur_id) {
+    if (!cache->entries || line_hash == 0) return NULL;
+
+    size_t mask = cache->capacity - 1;
+    for (size_t index = line_hash & mask; cache->entries[index].line_hash != 0; index = (index + 1) & mask) {
+        const CacheEntry* entry = &cache->entries[index];
+        if (entry->line_hash != line_hash) continue;
+
+        if (!labels || entry->env_hash == label_env_hash(labels, entry->deps, entry->dep_count, cur_id)) return entry;
+    }
+
+    return NULL;
+}
+
+void cache_insert(AsmCache* cache, const CacheEntry* entry, int* const err_code) {
+    _LOG_FAIL_CHECK_(cache->entries, "error", ERROR_REPORTS, return, err_code, ENOENT);
+    _LOG_FAIL_CHECK_(entry->line_hash, "error", ERROR_REPORTS, return, err_code, EINVAL);
+
+    if ((cache->size + 1) * 2 > cache->capacity) {
+        cache_grow(cache, err_code);
+        if (!cache->entries) return;
+    }
+
+    size_t mask = cache->capacity - 1;
+    size_t index = entry->line_hash & mask;
+    for (; cache->entries[index].line_hash != 0; index = (index + 1) & mask) {
+        if (same_entry(&cache->entries[index], entry)) return;
+    }
+
+    cache->entries[index] = *entry;
+    ++cache->size;
+}
+
+void cache_load(AsmCache* cache, const char* file_name, hash_t stamp, int* const err_code) {
+    _LOG_FAIL_CHECK_(file_name, "error", ERROR_REPORTS, return, err_code, EFAULT);
+
+    //* Missing cache file is not an error.
+    int prev_errno = errno;
+    FILE* file = fopen(file_name, "rb");
+    if (!file) {
+        log_printf(STATUS_REPORTS, "status", "Cache file %s does not exist yet.\n", file_name);
+        errno = prev_errno;
+        return;
+    }
+
+    char prefix[sizeof(CACHE_PREFIX)] = "";
+    hash_t file_stamp = 0;
+    size_t count = 0;
+
+    if (fread(prefix, sizeof(char), sizeof(CACHE_PREFIX) - 1, file) != sizeof(CACHE_PREFIX) - 1 ||
+        fread(&file_stamp, sizeof(file_stamp), 1, file) != 1 ||
+        fread(&count, sizeof(count), 1, file) != 1 ||
+        strcmp(prefix, CACHE_PREFIX) != 0 || file_stamp != stamp) {
+
+        log_printf(WARNINGS, "warning", "Cache file %s is outdated or corrupt, ignoring it.\n", file_name);
+        fclose(file);
+        return;
+    }
+
+    CacheEntry entry = {};
+    for (size_t entry_id = 0; entry_id < count; ++entry_id) {
+        if (fread(&entry, sizeof(entry), 1, file) != 1) break;
+        if (entry.line_hash == 0 || entry.size > MAX_CACHED_CMD_LENGTH || entry.dep_count > MAX_LABEL_DEPS) break;
+
+        cache_insert(cache, &entry, err_code);
+    }
+
+    log_printf(STATUS_REPORTS, "status", "Loaded %lu cache entries from %s.\n", cache->size, file_name);
+
+    fclose(file);
+}
+
+void cache_save(const AsmCache* cache, const char* file_name, hash_t stamp, int* const err_code) {
+    _LOG_FAIL_CHECK_(file_name, "error", ERROR_REPORTS, return, err_code, EFAULT);
+    _LOG_FAIL_CHECK_(cache->entries, "error", ERROR_REPORTS, return, err_code, ENOENT);
+
+    FILE* file = fopen(file_name, "wb");
+    _LOG_FAIL_CHECK_(file, "warning", WARNINGS, {
+        log_printf(WARNINGS, "warning", "Failed to create cache file %s.\n", file_name);
+        return;
+    }, NULL, 0);
+
+    fwrite(CACHE_PREFIX, sizeof(char), sizeof(CACHE_PREFIX) - 1, file);
+    fwrite(&stamp, sizeof(stamp), 1, file);
+    fwrite(&cache->size, sizeof(cache->size), 1, file);
+
+    for (size_t index = 0; index < cache->capacity; ++index) {
+        if (cache->entries[index].line_hash) fwrite(&cache->entries[index], sizeof(*cache->entries), 1, file);
+    }
+
+    fclose(file);
+}
+
+static bool same_entry(const CacheEntry* alpha, const CacheEntry* beta) {
+    return alpha->line_hash == beta->line_hash &&
+           alpha->env_hash  == beta->env_hash  &&
+           alpha->dep_count == beta->dep_count &&
+           memcmp(alpha->deps, beta->deps, alpha->dep_count * sizeof(*alpha->deps)) == 0;
+}
+
+static void cache_grow(AsmCache* cache, int* const err_code) {
+    AsmCache bigger = {};
+    AsmCache_ctor(&bigger, cache->capacity * 2);
+    _LOG_FAIL_CHECK_(bigger.entries, "error", ERROR_REPORTS, return, err_code, ENOMEM);
+
+    for (size_t index = 0; index < cache->capacity; ++index) {
+        if (cache->entries[index].line_hash) cache_insert(&bigger, &cache->entries[index], err_code);
+    }
+
+    AsmCache_dtor(cache);
+    *cache = bigger;
+}
\ No newline at end of file
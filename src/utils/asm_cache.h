@@ -0,0 +1,117 @@
+/**
+ * @file asm_cache.h
+ * @author Kudryashov Ilya (kudriashov.it@phystech.edu)
+ * @brief On-disk cache of encoded source lines for incremental reassembly.
+ * @version 0.1
+ * @date 2022-11-02
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#ifndef ASM_CACHE_H
+#define ASM_CACHE_H
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "lib/util/dbg/debug.h"
+#include "labels.h"
+
+//* Max number of labels a single cached line can depend on.
+const size_t MAX_LABEL_DEPS = 4;
+//* Max byte length of cached line encoding, longer lines are always re-encoded.
+const size_t MAX_CACHED_CMD_LENGTH = 64;
+
+static const char CACHE_PREFIX[] = "KITc";
+
+/**
+ * @brief Encoded source line.
+ * 
+ * Line encoding depends only on the line text and on distances from the line to the labels it uses,
+ * so entry stays valid while neither of them changes.
+ * 
+ * @param line_hash hash of the line text
+ * @param env_hash hash of label distances from the line (see label_env_hash())
+ * @param deps hashes of the labels the line depends on
+ * @param dep_count number of label dependencies
+ * @param size number of encoded bytes
+ * @param content encoded bytes
+ */
+struct CacheEntry {
+    hash_t line_hash = 0;
+    hash_t env_hash = 0;
+    hash_t deps[MAX_LABEL_DEPS] = {};
+    size_t dep_count = 0;
+    size_t size = 0;
+    char content[MAX_CACHED_CMD_LENGTH] = "";
+};
+
+/**
+ * @brief Hash table of cache entries (open addressing, capacity is a power of two).
+ * 
+ * @param entries entry array
+ * @param size number of stored entries
+ * @param capacity size of the entry array
+ */
+struct AsmCache {
+    CacheEntry* entries = NULL;
+    size_t size = 0;
+    size_t capacity = 0;
+};
+
+void AsmCache_ctor(AsmCache* cache, size_t capacity = 1024);
+void AsmCache_dtor(AsmCache* cache);
+
+/**
+ * @brief Calculate hash of label distances from the specified point.
+ * 
+ * @param labels label table
+ * @param deps label hashes
+ * @param dep_count number of labels
+ * @param cur_id point to measure distances from
+ * @return hash_t 
+ */
+hash_t label_env_hash(const LabelSet* labels, const hash_t* deps, size_t dep_count, uintptr_t cur_id);
+
+/**
+ * @brief Find encoding of the line.
+ * 
+ * @param cache cache to search in
+ * @param line_hash hash of the line text
+ * @param labels current label table (NULL if only the size of the encoding is needed)
+ * @param cur_id address of the line
+ * @return const CacheEntry* valid entry or NULL
+ */
+const CacheEntry* cache_find(const AsmCache* cache, hash_t line_hash, const LabelSet* labels, uintptr_t cur_id);
+
+/**
+ * @brief Put entry into the cache (duplicates are ignored).
+ * 
+ * @param cache cache to put the entry into
+ * @param entry entry to store
+ * @param err_code variable to use as errno
+ */
+void cache_insert(AsmCache* cache, const CacheEntry* entry, int* const err_code = NULL);
+
+/**
+ * @brief Read cache from the file, missing or outdated files result in an empty cache.
+ * 
+ * @param cache constructed cache to fill
+ * @param file_name name of the cache file
+ * @param stamp assembler build stamp the cache should match
+ * @param err_code variable to use as errno
+ */
+void cache_load(AsmCache* cache, const char* file_name, hash_t stamp, int* const err_code = NULL);
+
+/**
+ * @brief Write cache to the file.
+ * 
+ * @param cache cache to write
+ * @param file_name name of the cache file
+ * @param stamp assembler build stamp
+ * @param err_code variable to use as errno
+ */
+void cache_save(const AsmCache* cache, const char* file_name, hash_t stamp, int* const err_code = NULL);
+
+#endif
\ No newline at end of file
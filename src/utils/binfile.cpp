@@ -0,0 +1,475 @@
+#include "binfile.h"
+
+#include <string.h>
+#include <stddef.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "lib/util/dbg/debug.h"
+#include "src/proccmd.h"
+#include "argworks.h"
+#include "packed_code.h"
+
+//* warning: stack protector not protecting function: all local arrays are less than 8 bytes long [-Wstack-protector]
+#pragma GCC diagnostic ignored "-Wstack-protector"
+
+static const size_t SECTION_ALIGNMENT = 4;
+static const size_t READ_BLOCK_SIZE = 4096;
+static const size_t CHECKSUM_POS = offsetof(BinHeader, checksum);
+
+//* Largest prime below 2^16 and the longest run of bytes before Adler-32 sums can overflow.
+static const uint32_t ADLER_MODULO = 65521;
+static const size_t ADLER_BLOCK = 5552;
+
+/**
+ * @brief Round size up to the section alignment.
+ *
+ * @param size
+ * @return size_t
+ */
+static size_t align_size(size_t size);
+
+/**
+ * @brief Convert version 1 binary to the current format.
+ *
+ * Commands get aligned arguments, register ids are moved to command headers and jumps are recalculated.
+ *
+ * @param content version 1 file content
+ * @param size file size
+ * @param program where to put the converted program
+ * @param err_code variable to use as errno
+ */
+static void convert_v1(const char* content, size_t size, Program* program, int* const err_code);
+
+/**
+ * @brief Expand packed code section into the program image.
+ *
+ * @param program program with file sections read
+ * @param packed packed code section
+ * @param err_code variable to use as errno
+ */
+static void unpack_program(Program* program, const char* packed, int* const err_code);
+
+/**
+ * @brief Map the file into memory or read it if it can not be mapped.
+ *
+ * @param file_name name of the file
+ * @param program where to put the file (file, file_size and mapped fields)
+ * @param err_code variable to use as errno
+ */
+static void open_file(const char* file_name, Program* program, int* const err_code);
+
+/**
+ * @brief Free the file loaded with open_file().
+ *
+ * @param program program to free the file of
+ */
+static void close_file(Program* program);
+
+void Program_dtor(Program* program) {
+    if (program->content && program->content != program->file) free(program->content);
+    close_file(program);
+    *program = {};
+}
+
+uint32_t get_checksum(const char* content, size_t size) {
+    uint32_t sum_a = 1, sum_b = 0;
+
+    for (size_t index = 0; index < size;) {
+        size_t block_end = size - index < ADLER_BLOCK ? size : index + ADLER_BLOCK;
+
+        for (; index < block_end; ++index) {
+            //* Checksum field itself is counted as zeros.
+            unsigned char byte = index - CHECKSUM_POS < sizeof(uint32_t) ? 0 : (unsigned char)content[index];
+            sum_a += byte;
+            sum_b += sum_a;
+        }
+
+        sum_a %= ADLER_MODULO;
+        sum_b %= ADLER_MODULO;
+    }
+
+    return sum_b << 16 | sum_a;
+}
+
+void write_binary(FILE* output, const BinSection* sections, size_t section_count, int* const err_code) {
+    _LOG_FAIL_CHECK_(output && sections, "error", ERROR_REPORTS, return, err_code, EFAULT);
+    _LOG_FAIL_CHECK_(section_count && section_count <= MAX_SECTIONS &&
+                     (sections[0].type == SECTION_CODE || sections[0].type == SECTION_PACKED),
+                     "error", ERROR_REPORTS, return, err_code, EINVAL);
+
+    BinHeader header = {};
+    memcpy(header.prefix, FILE_PREFIX, PREFIX_SIZE);
+
+    SectionEntry table[MAX_SECTIONS] = {};
+    size_t size = HEADER_SIZE;
+
+    for (size_t section_id = 0; section_id < section_count; ++section_id) {
+        if (section_id && sections[section_id].size == 0) continue;
+
+        SectionEntry* entry = &table[header.section_count++];
+        entry->type = (uint32_t)sections[section_id].type;
+        entry->offset = (uint32_t)size;
+        entry->size = (uint32_t)sections[section_id].size;
+
+        size += align_size(sections[section_id].size);
+    }
+
+    char* image = (char*) calloc(size, sizeof(*image));
+    _LOG_FAIL_CHECK_(image, "error", ERROR_REPORTS, return, err_code, ENOMEM);
+
+    for (size_t section_id = 0, entry_id = 0; section_id < section_count; ++section_id) {
+        if (section_id && sections[section_id].size == 0) continue;
+
+        if (sections[section_id].size) {
+            memcpy(image + table[entry_id].offset, sections[section_id].content, sections[section_id].size);
+        }
+        ++entry_id;
+    }
+
+    memcpy(image, &header, sizeof(header));
+    memcpy(image + sizeof(header), table, sizeof(table));
+
+    header.checksum = get_checksum(image, size);
+    memcpy(image + CHECKSUM_POS, &header.checksum, sizeof(header.checksum));
+
+    fwrite(image, sizeof(char), size, output);
+
+    free(image);
+}
+
+version_t read_header(const char* content, size_t size, int* const err_code) {
+    _LOG_FAIL_CHECK_(content, "error", ERROR_REPORTS, return 0, err_code, EFAULT);
+
+    _LOG_FAIL_CHECK_(size >= V1_HEADER_SIZE && strncmp(FILE_PREFIX, content, PREFIX_SIZE) == 0, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Wrong file prefix, expected prefix - \"%s\".\n", FILE_PREFIX);
+        return 0;
+    }, err_code, EIO);
+
+    version_t version = 0;
+    memcpy(&version, content + PREFIX_SIZE, sizeof(version));
+
+    _LOG_FAIL_CHECK_(version == 1 || version == PROC_VERSION, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Wrong file version, file version - %d, processor version - %d.\n",
+                                           version, PROC_VERSION);
+        return 0;
+    }, err_code, EIO);
+
+    return version;
+}
+
+void load_program(const char* file_name, Program* program, int* const err_code) {
+    _LOG_FAIL_CHECK_(file_name && program, "error", ERROR_REPORTS, return, err_code, EFAULT);
+
+    open_file(file_name, program, err_code);
+    if (!program->file) return;
+
+    version_t version = read_header(program->file, program->file_size, err_code);
+
+    if (version == PROC_VERSION) {
+        program->content = program->file;
+        program->size = program->file_size;
+        read_sections(program, err_code);
+        return;
+    }
+
+    //* Converted program does not refer to the file.
+    if (version == 1) convert_v1(program->file, program->file_size, program, err_code);
+
+    close_file(program);
+}
+
+static void open_file(const char* file_name, Program* program, int* const err_code) {
+    int fd = open(file_name, O_RDONLY);
+    _LOG_FAIL_CHECK_(fd != -1, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Failed to open binary file %s.\n", file_name);
+        return;
+    }, err_code, ENOENT);
+
+    struct stat info = {};
+    fstat(fd, &info);
+
+    if (S_ISREG(info.st_mode) && info.st_size > 0) {
+        void* mapping = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (mapping != MAP_FAILED) {
+            madvise(mapping, (size_t)info.st_size, MADV_SEQUENTIAL);
+            madvise(mapping, (size_t)info.st_size, MADV_WILLNEED);
+            program->file = (char*) mapping;
+            program->file_size = (size_t)info.st_size;
+            program->mapped = true;
+            close(fd);
+            return;
+        }
+    }
+
+    log_printf(STATUS_REPORTS, "status", "Reading binary file %s as a stream.\n", file_name);
+
+    //* Reads can be short and pipes have no length, so the file is read until its end.
+    size_t capacity = 0;
+    ssize_t length = 0;
+
+    do {
+        program->file_size += (size_t)length;
+
+        if (program->file_size + READ_BLOCK_SIZE > capacity) {
+            capacity = capacity ? capacity * 2 : READ_BLOCK_SIZE;
+
+            char* new_file = (char*) realloc(program->file, capacity);
+            _LOG_FAIL_CHECK_(new_file, "error", ERROR_REPORTS, {
+                close(fd);
+                close_file(program);
+                return;
+            }, err_code, ENOMEM);
+            program->file = new_file;
+        }
+
+        length = read(fd, program->file + program->file_size, READ_BLOCK_SIZE);
+    } while (length > 0);
+
+    close(fd);
+
+    _LOG_FAIL_CHECK_(length == 0, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Failed to read binary file %s.\n", file_name);
+        close_file(program);
+        return;
+    }, err_code, EIO);
+}
+
+static void close_file(Program* program) {
+    if (program->mapped) munmap(program->file, program->file_size);
+    else if (program->file) free(program->file);
+
+    program->file = NULL;
+    program->file_size = 0;
+    program->mapped = false;
+}
+
+void read_sections(Program* program, int* const err_code, bool trusted) {
+    BinHeader header = {};
+    SectionEntry table[MAX_SECTIONS] = {};
+
+    _LOG_FAIL_CHECK_(program->size >= HEADER_SIZE, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Binary file is shorter than its header.\n");
+        Program_dtor(program);
+        return;
+    }, err_code, EIO);
+
+    memcpy(&header, program->content, sizeof(header));
+    memcpy(table, program->content + sizeof(header), sizeof(table));
+
+    _LOG_FAIL_CHECK_(trusted || header.checksum == get_checksum(program->content, program->size), "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Binary file checksum mismatch, the file is damaged.\n");
+        Program_dtor(program);
+        return;
+    }, err_code, EIO);
+
+    _LOG_FAIL_CHECK_(header.section_count <= MAX_SECTIONS, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Binary file has %u sections, maximum is %lu.\n",
+                                           header.section_count, MAX_SECTIONS);
+        Program_dtor(program);
+        return;
+    }, err_code, EIO);
+
+    unsigned int found_types = 0;
+    const char* packed = NULL;
+
+    for (size_t entry_id = 0; entry_id < header.section_count; ++entry_id) {
+        const SectionEntry* entry = &table[entry_id];
+
+        _LOG_FAIL_CHECK_(SECTION_CODE <= entry->type && entry->type <= SECTION_PACKED &&
+                         !(found_types & (1u << entry->type)) && entry->reserved == 0 &&
+                         entry->offset >= HEADER_SIZE && entry->offset % SECTION_ALIGNMENT == 0 &&
+                         entry->offset <= program->size && entry->size <= program->size - entry->offset,
+                         "error", ERROR_REPORTS, {
+            log_printf(ERROR_REPORTS, "error", "Section table entry %lu (type %u, %u bytes at 0x%X) is invalid.\n",
+                                               entry_id, entry->type, entry->size, entry->offset);
+            Program_dtor(program);
+            return;
+        }, err_code, EIO);
+
+        found_types |= 1u << entry->type;
+
+        const char* section = program->content + entry->offset;
+
+        switch (entry->type) {
+            case SECTION_PACKED:
+            case SECTION_CODE: {
+                _LOG_FAIL_CHECK_(entry->offset == HEADER_SIZE && program->code_end == 0 &&
+                                 (entry->type == SECTION_PACKED || entry->size % CMD_HEADER_SIZE == 0),
+                                 "error", ERROR_REPORTS, {
+                    log_printf(ERROR_REPORTS, "error", "Code section should start at 0x%lX and consist of whole commands.\n",
+                                                       HEADER_SIZE);
+                    Program_dtor(program);
+                    return;
+                }, err_code, EIO);
+
+                program->code_end = entry->offset + entry->size;
+                if (entry->type == SECTION_PACKED) {
+                    packed = section;
+                    program->packed_size = entry->size;
+                }
+            } break;
+
+            case SECTION_DATA: {
+                program->data = section;
+                program->data_size = entry->size;
+            } break;
+
+            case SECTION_SYMBOLS: {
+                program->symbols = section;
+                program->symbols_size = entry->size;
+            } break;
+
+            case SECTION_DEBUG: {
+                program->debug = section;
+                program->debug_size = entry->size;
+            } break;
+
+            default: break;
+        }
+    }
+
+    _LOG_FAIL_CHECK_(found_types & (1u << SECTION_CODE | 1u << SECTION_PACKED), "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Binary file has no code section.\n");
+        Program_dtor(program);
+        return;
+    }, err_code, EIO);
+
+    program->version = header.version;
+
+    if (packed) unpack_program(program, packed, err_code);
+}
+
+static void unpack_program(Program* program, const char* packed, int* const err_code) {
+    size_t code_size = unpack_code(packed, program->packed_size, NULL, err_code);
+    _LOG_FAIL_CHECK_(code_size || program->packed_size == 0, "error", ERROR_REPORTS, {
+        Program_dtor(program);
+        return;
+    }, err_code, EIO);
+
+    //* Other sections stay in the file, so the image holds only the header and the code.
+    char* image = (char*) calloc(HEADER_SIZE + code_size + 1, sizeof(*image));
+    _LOG_FAIL_CHECK_(image, "error", ERROR_REPORTS, {
+        Program_dtor(program);
+        return;
+    }, err_code, ENOMEM);
+
+    memcpy(image, program->file, HEADER_SIZE);
+    unpack_code(packed, program->packed_size, image + HEADER_SIZE, err_code);
+
+    program->content = image;
+    program->size = HEADER_SIZE + code_size;
+    program->code_end = HEADER_SIZE + code_size;
+
+    log_printf(STATUS_REPORTS, "status", "Packed code of %lu bytes was expanded into %lu bytes.\n",
+                                         program->packed_size, code_size);
+}
+
+static void convert_v1(const char* content, size_t size, Program* program, int* const err_code) {
+    unsigned int data_offset = 0, data_size = 0;
+    memcpy(&data_offset, content + V1_DATA_OFFSET_POS, sizeof(data_offset));
+    memcpy(&data_size, content + V1_DATA_SIZE_POS, sizeof(data_size));
+
+    if (data_size == 0) data_offset = (unsigned int)size;
+
+    _LOG_FAIL_CHECK_(V1_HEADER_SIZE <= data_offset && data_offset <= size && data_size <= size - data_offset,
+                     "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Data section of %u bytes at 0x%X does not fit into %lu byte file.\n",
+                                           data_size, data_offset, size);
+        return;
+    }, err_code, EIO);
+
+    size_t code_end = data_offset;
+
+    //* New offsets of the commands by their old offsets (0 - not a start of a command).
+    uint32_t* new_offsets = (uint32_t*) calloc(code_end + 1, sizeof(*new_offsets));
+    _LOG_FAIL_CHECK_(new_offsets, "error", ERROR_REPORTS, return, err_code, ENOMEM);
+
+    size_t new_size = HEADER_SIZE;
+    for (size_t offset = V1_HEADER_SIZE; offset < code_end;) {
+        unsigned int cmd_id = (unsigned char)content[offset] >> 2;
+        size_t length = (size_t)cmd_length_v1(cmd_id);
+
+        _LOG_FAIL_CHECK_(length && offset + length <= code_end, "error", ERROR_REPORTS, {
+            log_printf(ERROR_REPORTS, "error", "Invalid version 1 command [%0X] at 0x%0*lX.\n",
+                                               cmd_id, (int)sizeof(uintptr_t), offset);
+            free(new_offsets);
+            return;
+        }, err_code, EIO);
+
+        new_offsets[offset] = (uint32_t)new_size;
+        new_size += (size_t)cmd_length(cmd_id);
+        offset += length;
+    }
+
+    size_t new_code_end = new_size;
+
+    program->content = (char*) calloc(new_code_end + data_size + 1, sizeof(*program->content));
+    _LOG_FAIL_CHECK_(program->content, "error", ERROR_REPORTS, {
+        free(new_offsets);
+        return;
+    }, err_code, ENOMEM);
+
+    for (size_t offset = V1_HEADER_SIZE; offset < code_end; offset += (size_t)cmd_length_v1((unsigned char)content[offset] >> 2)) {
+        unsigned int cmd_id = (unsigned char)content[offset] >> 2;
+        const CmdInfo* info = &CMD_INFO[cmd_id];
+        char* command = program->content + new_offsets[offset];
+
+        command[0] = content[offset];
+
+        if (info->arg_size != sizeof(int)) {
+            memcpy(command + CMD_HEADER_SIZE, content + offset + 1, info->arg_size);
+            continue;
+        }
+
+        int argument = 0;
+        memcpy(&argument, content + offset + 1, sizeof(argument));
+
+        char usage = (char)(content[offset] & 3);
+        if ((info->flags & CMD_F_MASKED) && usage == USE_REGISTER) {
+            command[1] = (char)argument;
+            argument = 0;
+        } else if ((info->flags & CMD_F_MASKED) && usage == (USE_REGISTER | USE_MEMORY)) {
+            //* Version 1 packed register id into the lowest byte and the offset into the upper three.
+            command[1] = (char)(argument & 0xFF);
+            argument >>= 8;
+        }
+
+        if (info->flags & CMD_F_BRANCH) {
+            long long target = (long long)offset + argument;
+
+            _LOG_FAIL_CHECK_(target >= (long long)V1_HEADER_SIZE && target < (long long)code_end && new_offsets[target],
+                             "error", ERROR_REPORTS, {
+                log_printf(ERROR_REPORTS, "error", "Command %s at 0x%0*lX jumps to 0x%llX, which is not a start of a command.\n",
+                                                   info->name, (int)sizeof(uintptr_t), offset, target);
+                free(new_offsets);
+                Program_dtor(program);
+                return;
+            }, err_code, EIO);
+
+            argument = (int)new_offsets[target] - (int)new_offsets[offset];
+        }
+
+        memcpy(command + CMD_HEADER_SIZE, &argument, sizeof(argument));
+    }
+
+    free(new_offsets);
+
+    if (data_size) memcpy(program->content + new_code_end, content + data_offset, data_size);
+
+    program->size = new_code_end + data_size;
+    program->version = 1;
+    program->code_end = new_code_end;
+    program->data = data_size ? program->content + new_code_end : NULL;
+    program->data_size = data_size;
+
+    log_printf(STATUS_REPORTS, "status", "Version 1 binary of %lu bytes was converted into %lu bytes.\n",
+                                         size, program->size);
+}
+
+static size_t align_size(size_t size) {
+    return (size + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+}
@@ -0,0 +1,162 @@
+/**
+ * @file binfile.h
+ * @author Kudryashov Ilya (kudriashov.it@phystech.edu)
+ * @brief Program binaries with section table and checksum (with loading of version 1 binaries).
+ * @version 0.1
+ * @date 2022-11-09
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#ifndef BINFILE_H
+#define BINFILE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "src/procinfo.h"
+
+//* Types of section table entries.
+enum SectionType {
+    SECTION_CODE    = 1,  // commands, always placed right after the section table
+    SECTION_DATA    = 2,  // initial RAM contents (see DataBlock)
+    SECTION_SYMBOLS = 3,  // exported labels (see ObjSymbol)
+    SECTION_DEBUG   = 4,  // embedded source map (see DebugInfo)
+    SECTION_PACKED  = 5,  // commands in the dense form (see pack_code), used instead of the code section
+};
+
+/**
+ * @brief Binary file header, followed by MAX_SECTIONS section table entries.
+ * 
+ * @param prefix file prefix (FILE_PREFIX)
+ * @param version binary format version
+ * @param section_count number of used section table entries
+ * @param checksum Adler-32 of the whole file with this field set to 0
+ */
+struct BinHeader {
+    char prefix[4] = {};
+    version_t version = PROC_VERSION;
+    uint32_t section_count = 0;
+    uint32_t checksum = 0;
+};
+
+/**
+ * @brief Section table entry.
+ * 
+ * @param type SectionType of the section
+ * @param offset section offset from the start of the file (aligned to 4 bytes)
+ * @param size section size in bytes
+ * @param reserved should be 0
+ */
+struct SectionEntry {
+    uint32_t type = 0;
+    uint32_t offset = 0;
+    uint32_t size = 0;
+    uint32_t reserved = 0;
+};
+
+static_assert(sizeof(BinHeader) + MAX_SECTIONS * sizeof(SectionEntry) == HEADER_SIZE,
+              "Section table does not match the header size.");
+
+/**
+ * @brief Section content to write.
+ * 
+ * @param type section type
+ * @param content section content
+ * @param size section size
+ */
+struct BinSection {
+    SectionType type = SECTION_CODE;
+    const char* content = NULL;
+    size_t size = 0;
+};
+
+/**
+ * @brief Program loaded into memory in the current binary format.
+ * 
+ * @param content program image, code starts at HEADER_SIZE
+ * @param size image size
+ * @param file loaded file (same as content unless the code was converted or unpacked)
+ * @param file_size file size
+ * @param mapped true if the file is a read-only memory mapping, false if it was read into a buffer
+ * @param version format version of the loaded file
+ * @param packed_size size of the packed code section (0 if the code was not packed)
+ * @param code_end offset of the end of the code
+ * @param data data section
+ * @param data_size size of the data section
+ * @param symbols symbol section
+ * @param symbols_size size of the symbol section
+ * @param debug embedded source map
+ * @param debug_size size of the embedded source map
+ */
+struct Program {
+    char* content = NULL;
+    size_t size = 0;
+    char* file = NULL;
+    size_t file_size = 0;
+    bool mapped = false;
+    version_t version = 0;
+    size_t packed_size = 0;
+    size_t code_end = 0;
+    const char* data = NULL;
+    size_t data_size = 0;
+    const char* symbols = NULL;
+    size_t symbols_size = 0;
+    const char* debug = NULL;
+    size_t debug_size = 0;
+};
+
+void Program_dtor(Program* program);
+
+/**
+ * @brief Calculate checksum of the binary file.
+ * 
+ * @param content file content
+ * @param size file size
+ * @return uint32_t Adler-32 of the file with the checksum field treated as 0
+ */
+uint32_t get_checksum(const char* content, size_t size);
+
+/**
+ * @brief Write binary file with the header, section table and checksum.
+ * 
+ * @param output file to write to
+ * @param sections sections to write, code or packed code section should go first
+ * @param section_count number of sections (empty sections other than code are skipped)
+ * @param err_code variable to use as errno
+ */
+void write_binary(FILE* output, const BinSection* sections, size_t section_count, int* const err_code = NULL);
+
+/**
+ * @brief Check file prefix and get binary format version.
+ * 
+ * @param content file content
+ * @param size file size
+ * @param err_code variable to use as errno
+ * @return version_t format version (0 if the file is not a supported binary)
+ */
+version_t read_header(const char* content, size_t size, int* const err_code = NULL);
+
+/**
+ * @brief Validate header and section table of the current version binary and fill program sections.
+ * 
+ * @param program program with content and size set (content is freed on failure)
+ * @param err_code variable to use as errno
+ * @param trusted skip the checksum (for images that were already checked, see image_cache.h)
+ */
+void read_sections(Program* program, int* const err_code = NULL, bool trusted = false);
+
+/**
+ * @brief Read and validate binary file, version 1 binaries are converted to the current format.
+ * 
+ * Regular files are mapped read-only, so processes running the same program share its pages.
+ * 
+ * @param file_name name of the binary file
+ * @param program where to put the program
+ * @param err_code variable to use as errno
+ */
+void load_program(const char* file_name, Program* program, int* const err_code = NULL);
+
+#endif
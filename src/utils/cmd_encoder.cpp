@@ -0,0 +1,114 @@
+#include "cmd_encoder.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "lib/util/dbg/debug.h"
+#include "src/proccmd.h"
+#include "argworks.h"
+#include "natives.h"
+
+#define ASSEMBLER
+
+//* warning: stack protector not protecting function: all local arrays are less than 8 bytes long [-Wstack-protector]
+#pragma GCC diagnostic ignored "-Wstack-protector"
+
+/**
+ * @brief Get label value and remember that the command depends on it.
+ *
+ * @param encoder command environment
+ * @param hash label name hash
+ * @param err_code variable to use as errno
+ * @return uintptr_t label value
+ */
+static uintptr_t use_label(CmdEncoder* encoder, hash_t hash, int* const err_code);
+
+/**
+ * @brief Read jump destination and get its distance from the command.
+ *
+ * @param encoder command environment
+ * @param arg_ptr label name or relative distance
+ * @param err_code variable to use as errno
+ * @return int distance to the destination
+ */
+static int jump_distance(CmdEncoder* encoder, const char* arg_ptr, int* const err_code);
+
+#define DEF_CMD(name, meta, parse_script, exec_script, disasm_script) \
+    if (hash == CMD_HASHES[CMD_##name]) { \
+        *cmd_id = CMD_##name; sequence[0] = (char)(CMD_##name << 2); cmd_size = CMD_HEADER_SIZE; parse_script; \
+    } else
+
+#define ARG_PTR                 ( text + shift )
+#define GET_LABEL(arg)          use_label(encoder, arg, err_code)
+#define GET_DISTANCE(arg_ptr)   jump_distance(encoder, arg_ptr, err_code)
+#define CUR_ID                  ( encoder->position )
+#define BUF_PTR                 sequence
+#define BUF_WRITE(ptr, length)  { memcpy(sequence + cmd_size, ptr, length); cmd_size += length; }
+#define ERRNO                   err_code
+#define LABEL_LIST              encoder->labels
+#define VARIANT                 variant
+
+#define if_cmd_not_defined
+
+size_t encode_command(CmdEncoder* encoder, hash_t hash, const char* text, int shift, char* sequence,
+                      unsigned int* cmd_id, int* const err_code) {
+    _LOG_FAIL_CHECK_(encoder && text && sequence && cmd_id, "error", ERROR_REPORTS, return 0, err_code, EFAULT);
+
+    size_t cmd_size = 0;
+
+    //* Variants are encoded as the command implementing them.
+    unsigned char variant = 0;
+    for (size_t alias_id = 0; alias_id < CMD_ALIAS_COUNT; ++alias_id) {
+        if (hash != CMD_ALIAS_HASHES[alias_id]) continue;
+        hash = CMD_HASHES[CMD_ALIASES[alias_id].cmd_id];
+        variant = CMD_ALIASES[alias_id].variant;
+        break;
+    }
+
+    #include "src/cmddef.h"
+
+    if_cmd_not_defined {
+        return 0;
+    }
+
+    //* Parse scripts may switch to a related command by rewriting the opcode.
+    *cmd_id = (unsigned char)sequence[0] >> 2;
+
+    return cmd_size;
+}
+
+#undef DEF_CMD
+
+static int jump_distance(CmdEncoder* encoder, const char* arg_ptr, int* const err_code) {
+    char lbl_name[LABEL_MAX_NAME_LENGTH] = "";
+    int argument = 0;
+
+    sscanf(arg_ptr, "%d", &argument);
+
+    if (argument == 0) {
+        static_assert(LABEL_MAX_NAME_LENGTH == 128, "Label name width in the scan format should be updated.");
+        int length = 0;
+        sscanf(arg_ptr, " %127s%n", lbl_name, &length);
+
+        const char* name_end = arg_ptr + length;
+        _LOG_FAIL_CHECK_(*name_end == '\0' || isspace(*name_end), "error", ERROR_REPORTS, {
+            log_printf(ERROR_REPORTS, "error", "Label name \"%s...\" is longer than %lu characters.\n",
+                                               lbl_name, LABEL_MAX_NAME_LENGTH - 1);
+            return 0;
+        }, err_code, E2BIG);
+
+        hash_t lbl_hash = get_hash(lbl_name, lbl_name + strlen(lbl_name));
+        argument = (int)use_label(encoder, lbl_hash, err_code) - (int)CUR_ID;
+    }
+
+    return argument;
+}
+
+static uintptr_t use_label(CmdEncoder* encoder, hash_t hash, int* const err_code) {
+    //* Commands with too many dependencies are marked by dep_count > MAX_LABEL_DEPS and never cached.
+    if (encoder->dep_count < MAX_LABEL_DEPS) encoder->deps[encoder->dep_count] = hash;
+    if (encoder->dep_count <= MAX_LABEL_DEPS) ++encoder->dep_count;
+
+    return get_label(encoder->labels, hash, err_code);
+}
@@ -0,0 +1,52 @@
+/**
+ * @file cmd_encoder.h
+ * @author Kudryashov Ilya (kudriashov.it@phystech.edu)
+ * @brief Encoding of single assembler commands.
+ * @version 0.1
+ * @date 2022-11-12
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef CMD_ENCODER_H
+#define CMD_ENCODER_H
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "common.h"
+#include "labels.h"
+#include "asm_cache.h"
+
+/**
+ * @brief Environment the command is encoded in.
+ *
+ * @param labels labels the command can refer to
+ * @param position address of the command in the binary
+ * @param deps labels used by the command
+ * @param dep_count number of labels used by the command (MAX_LABEL_DEPS + 1 if some of them did not fit)
+ */
+struct CmdEncoder {
+    const LabelSet* labels = NULL;
+    uintptr_t position = 0;
+    hash_t deps[MAX_LABEL_DEPS] = {};
+    size_t dep_count = 0;
+};
+
+/**
+ * @brief Encode the command into its binary form.
+ *
+ * @param encoder labels and position of the command, receives labels the command uses
+ * @param hash hash of the command name
+ * @param text NUL-terminated command line
+ * @param shift position of the command argument in the line
+ * @param sequence buffer of MAX_CMD_BITE_LENGTH bytes to write the command to
+ * @param cmd_id where to put the command id
+ * @param err_code variable to use as errno
+ * @return size_t size of the encoded command (0 if the command is unknown)
+ */
+size_t encode_command(CmdEncoder* encoder, hash_t hash, const char* text, int shift, char* sequence,
+                      unsigned int* cmd_id, int* const err_code = NULL);
+
+#endif
@@ -0,0 +1,127 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "lib/util/dbg/debug.h"
+#include "src/proccmd.h"
+#include "argworks.h"
+#include "mem_kernels.h"
+#include "raster.h"
+#include "console.h"
+#include "timer.h"
+
+#define PROCESSOR
+
+#include "cmd_executor.h"
+#include "natives.h"
+#include "vm_threads.h"
+
+//* warning: stack protector not protecting function: all local arrays are less than 8 bytes long [-Wstack-protector]
+#pragma GCC diagnostic ignored "-Wstack-protector"
+
+/**
+ * @brief Make console empty.
+ * 
+ */
+static void clear_console();
+
+/**
+ * @brief Draw picture stored in VMD to the screen with UTF8 characters.
+ * 
+ */
+static void draw_vmd(FrameBuffer* buffer);
+
+#define _LOG_EMPT_STACK_(command) do {                                                      \
+    _LOG_FAIL_CHECK_(stack->size, "error", ERROR_REPORTS, {                                 \
+        log_printf(ERROR_REPORTS, "error", "Request to the empty stack in %s.\n", command); \
+        shift = 0;                                                                          \
+        break;                                                                              \
+    }, err_code, EFAULT);                                                                   \
+} while (0)
+
+#define DEF_CMD(name, meta, parse_script, exec_script, disasm_script) case CMD_##name: { \
+    log_printf(STATUS_REPORTS, "status", "Executing command " #name " (mask %d) at 0x%0*X.\n", \
+                                         *ptr & 3, sizeof(void*), ptr - prog_start); \
+    const char *COMMAND_NAME = #name; \
+    COMMAND_NAME = COMMAND_NAME; \
+    exec_script; \
+} break;
+
+#define STACK           stack
+#define ADDR_STACK      addr_stack
+#define FRAMES          frames
+#define SHIFT           shift
+#define EXEC_POINT      ptr
+#define ARG_PTR         ptr + CMD_HEADER_SIZE
+#define ERRNO           err_code
+#define REG             ( *reg )
+#define RAM             ( *ram )
+#define VMD_SIZE        (vmd->width * vmd->height)
+#define VMD             ( *vmd )
+#define PUSH(value)     stack_push(STACK, value, ERRNO)
+#define GET_TOP(var)    _LOG_EMPT_STACK_(COMMAND_NAME); var = stack_get(STACK, ERRNO)
+#define POP_TOP()       stack_pop(STACK, ERRNO)
+
+int execute_command(const char* prog_start, const char* ptr,
+                    Stack* const stack, Stack* const addr_stack, FrameStack* frames,
+                    MemorySegment* ram, MemorySegment* reg, FrameBuffer* vmd,
+                    int* const err_code) {
+    _LOG_FAIL_CHECK_(ptr, "error", ERROR_REPORTS, return 0, err_code, EFAULT);
+
+    // log_printf(STATUS_REPORTS, "status", "Executing command %02X (mask %d) at 0x%0*X.\n", 
+    //            (*ptr >> 2) & 0xFF, *ptr & 3, sizeof(prog_start), ptr - prog_start);
+    
+    _LOG_FAIL_CHECK_(stack_status(stack) == 0, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Memory stack status check failed.\n");
+        stack_dump(stack, ERROR_REPORTS);
+        return 0;
+    }, NULL, 0);
+
+    _LOG_FAIL_CHECK_(stack_status(addr_stack) == 0, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Address stack status check failed.\n");
+        stack_dump(addr_stack, ERROR_REPORTS);
+        return 0;
+    }, NULL, 0);
+
+    //* Commands fall through to the next one unless they change the shift.
+    int shift = cmd_length((unsigned char)*ptr >> 2);
+
+    switch ((unsigned char)*ptr >> 2) {
+        #include "src/cmddef.h"
+
+        default:
+            log_printf(ERROR_REPORTS, "error", "Unknown command [%0X]. Terminating.\n", (unsigned char)*ptr >> 2);
+            if (err_code) *err_code = EIO;
+            shift = 0;
+        break;
+    }
+
+    return shift;
+}
+
+#undef DEF_CMD
+
+#ifdef __linux__
+static void clear_console() {
+    system("clear");
+}
+#elif defined(WIN32) || defined(WIN64)
+static void clear_console() {
+    system("cls");
+}
+#endif
+
+static void draw_vmd(FrameBuffer* buffer) {
+    for (int id_y = 0; id_y < (int)buffer->height; ++id_y) {
+        for (int id_x = 0; id_x < (int)buffer->width; ++id_x) {
+
+            int brightness = buffer->content[id_y * (int)buffer->width + id_x];
+
+            brightness = clamp(brightness, 0, (int)sizeof(PIX_STATES) - 2);
+
+            console_put_char(PIX_STATES[brightness]);
+        }
+        console_put_char('\n');
+    }
+}
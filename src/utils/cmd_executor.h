@@ -0,0 +1,85 @@
+/**
+ * @file cmd_executor.h
+ * @author Kudryashov Ilya (kudriashov.it@phystech.edu)
+ * @brief Execution of single processor commands.
+ * @version 0.1
+ * @date 2022-11-12
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef CMD_EXECUTOR_H
+#define CMD_EXECUTOR_H
+
+#ifndef PROCESSOR
+    #error cmd_executor.h should only be included by the processor after its config.h.
+#endif
+
+#include <string.h>
+#include <limits.h>
+
+#include "src/config.h"
+#include "lib/_stackworks.h"
+
+#include "common.h"
+#include "frames.h"
+
+static_assert(sizeof(double) == sizeof(stack_content_t), "Stack cells can not store doubles.");
+
+/**
+ * @brief Store double in a stack cell.
+ * 
+ * @param value value to store
+ * @return stack_content_t cell with the same bits
+ */
+static inline stack_content_t pack_double(double value) {
+    stack_content_t cell = 0;
+    memcpy(&cell, &value, sizeof(cell));
+    return cell;
+}
+
+/**
+ * @brief Read double from a stack cell.
+ * 
+ * @param cell cell written by pack_double()
+ * @return double stored value
+ */
+static inline double unpack_double(stack_content_t cell) {
+    double value = 0;
+    memcpy(&value, &cell, sizeof(value));
+    return value;
+}
+
+/**
+ * @brief Check that the stack cell can be stored in a RAM, register or VMD cell without losing bits.
+ * 
+ * Floating-point values have to be converted with FTOI first.
+ * 
+ * @param cell stack cell
+ * @return true if the value is in the int range
+ */
+static inline bool fits_cell(stack_content_t cell) {
+    return INT_MIN <= cell && cell <= INT_MAX;
+}
+
+/**
+ * @brief Execute one command and return pointer shift.
+ * 
+ * @param prog_start start of the program image
+ * @param ptr pointer to the command
+ * @param stack stack to operate on
+ * @param addr_stack address stack
+ * @param frames local variable frames
+ * @param ram virtual RAM
+ * @param reg virtual register
+ * @param vmd virtual video memory device
+ * @param err_code error code
+ * @return int shift to the next command (0 if execution should stop)
+ */
+int execute_command(const char* prog_start, const char* ptr, 
+                    Stack* const stack, Stack* const addr_stack, FrameStack* frames,
+                    MemorySegment* ram, MemorySegment* reg, FrameBuffer* vmd, 
+                    int* const err_code = NULL);
+
+#endif
@@ -2,6 +2,18 @@
 
 #include <stdlib.h>
 #include <stdarg.h>
+#include <string.h>
+
+/**
+ * @brief Check if command line argument is a flag ("-" alone is a file name meaning standard input).
+ * 
+ * @param argument
+ * @return true if argument is a flag
+ */
+static bool is_flag(const char* argument);
+
+//* Initial capacity of the pseudo-file buffer.
+static const size_t PSEUDO_FILE_START_CAPACITY = 128;
 
 void** bundle(size_t count, ...) {
     va_list args;
@@ -18,6 +30,34 @@ void** bundle(size_t count, ...) {
     return array;
 }
 
+void PseudoFile_dtor(PseudoFile* file) {
+    if (file->content) free(file->content);
+    file->content = NULL;
+    file->size = 0;
+    file->capacity = 0;
+}
+
+void PseudoFile_reserve(PseudoFile* file, size_t extra, int* const err_code) {
+    if (file->size + extra <= file->capacity) return;
+
+    size_t new_capacity = file->capacity ? file->capacity : PSEUDO_FILE_START_CAPACITY;
+    while (new_capacity < file->size + extra) new_capacity *= 2;
+
+    char* new_content = (char*) realloc(file->content, new_capacity);
+    _LOG_FAIL_CHECK_(new_content, "error", ERROR_REPORTS, return, err_code, ENOMEM);
+
+    file->content = new_content;
+    file->capacity = new_capacity;
+}
+
+void PseudoFile_append(PseudoFile* file, const void* data, size_t size, int* const err_code) {
+    PseudoFile_reserve(file, size, err_code);
+    _LOG_FAIL_CHECK_(file->size + size <= file->capacity || size == 0, "error", ERROR_REPORTS, return, err_code, ENOMEM);
+
+    if (size) memcpy(file->content + file->size, data, size);
+    file->size += size;
+}
+
 void MemorySegment_ctor(MemorySegment* segment) {
     segment->content = (int*) calloc(segment->size, sizeof(*segment->content));
 }
@@ -72,7 +112,7 @@ const char* get_input_file_name(const int argc, const char** argv) {
     const char* file_name = NULL;
 
     for (int argument_id = 1; argument_id < argc; ++argument_id) {
-        if (*argv[argument_id] == '-') continue;
+        if (is_flag(argv[argument_id])) continue;
         file_name = argv[argument_id];
         break;
     }
@@ -85,11 +125,15 @@ const char* get_output_file_name(const int argc, const char** argv) {
 
     bool enc_first_name = false;
     for (int argument_id = 1; argument_id < argc; ++argument_id) {
-        if (*argv[argument_id] == '-') continue;
+        if (is_flag(argv[argument_id])) continue;
         file_name = argv[argument_id];
         if (enc_first_name) return file_name;
         else enc_first_name = true;
     }
 
     return NULL;
+}
+
+static bool is_flag(const char* argument) {
+    return argument[0] == '-' && argument[1] != '\0';
 }
\ No newline at end of file
@@ -50,6 +50,40 @@ void MemorySegment_dtor(MemorySegment* segment);
 
 void _MemorySegment_dump(MemorySegment* segment, unsigned int importance);
 
+/**
+ * @brief Binary buffer with its size.
+ * 
+ * @param content storage content of the p-file
+ * @param size number of filled bytes
+ * @param capacity number of allocated bytes
+ */
+struct PseudoFile {
+    char* content = NULL;
+    size_t size = 0;
+    size_t capacity = 0;
+};
+
+void PseudoFile_dtor(PseudoFile* file);
+
+/**
+ * @brief Make sure the file can store specified number of additional bytes.
+ * 
+ * @param file file to expand
+ * @param extra number of bytes to be written
+ * @param err_code variable to use as errno
+ */
+void PseudoFile_reserve(PseudoFile* file, size_t extra, int* const err_code = NULL);
+
+/**
+ * @brief Append raw bytes to the end of the file.
+ * 
+ * @param file file to append to
+ * @param data bytes to append
+ * @param size number of bytes
+ * @param err_code variable to use as errno
+ */
+void PseudoFile_append(PseudoFile* file, const void* data, size_t size, int* const err_code = NULL);
+
 /**
  * @brief Pseudo-2D array with defined dimensions.
  * 
@@ -0,0 +1,94 @@
+#include "console.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+#define PROCESSOR
+
+#include "src/config.h"
+
+//* warning: stack protector not protecting function: all local arrays are less than 8 bytes long [-Wstack-protector]
+#pragma GCC diagnostic ignored "-Wstack-protector"
+
+static char CONSOLE_BUFFER[CONSOLE_BUFFER_SIZE] = "";
+static size_t console_length = 0;
+//* Processor threads share the buffer, every public function holds the lock while it works with it.
+static pthread_mutex_t CONSOLE_MUTEX = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * @brief Write the buffer out (the lock should be held).
+ *
+ */
+static void flush_buffer();
+
+/**
+ * @brief Put characters into the buffer (the lock should be held).
+ *
+ * @param text characters to write
+ * @param length number of characters
+ */
+static void append(const char* text, size_t length);
+
+void console_write(const char* text, size_t length) {
+    pthread_mutex_lock(&CONSOLE_MUTEX);
+    append(text, length);
+    pthread_mutex_unlock(&CONSOLE_MUTEX);
+}
+
+void console_put_char(char character) {
+    pthread_mutex_lock(&CONSOLE_MUTEX);
+    if (console_length == CONSOLE_BUFFER_SIZE) flush_buffer();
+    CONSOLE_BUFFER[console_length++] = character;
+    pthread_mutex_unlock(&CONSOLE_MUTEX);
+}
+
+void console_put_int(long long value) {
+    //* Digits are written from the end of the buffer.
+    char digits[24] = "";
+    char* begin = digits + sizeof(digits);
+
+    unsigned long long magnitude = value < 0 ? 0ull - (unsigned long long)value : (unsigned long long)value;
+
+    do {
+        *--begin = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude);
+
+    if (value < 0) *--begin = '-';
+
+    console_write(begin, (size_t)(digits + sizeof(digits) - begin));
+}
+
+void console_put_cells(const int* cells, size_t count) {
+    pthread_mutex_lock(&CONSOLE_MUTEX);
+    for (size_t id = 0; id < count; ++id) {
+        if (console_length == CONSOLE_BUFFER_SIZE) flush_buffer();
+        CONSOLE_BUFFER[console_length++] = (char)cells[id];
+    }
+    pthread_mutex_unlock(&CONSOLE_MUTEX);
+}
+
+void console_flush() {
+    pthread_mutex_lock(&CONSOLE_MUTEX);
+    flush_buffer();
+    pthread_mutex_unlock(&CONSOLE_MUTEX);
+}
+
+static void flush_buffer() {
+    fwrite(CONSOLE_BUFFER, 1, console_length, stdout);
+    fflush(stdout);
+    console_length = 0;
+}
+
+static void append(const char* text, size_t length) {
+    if (console_length + length > CONSOLE_BUFFER_SIZE) flush_buffer();
+
+    if (length > CONSOLE_BUFFER_SIZE) {
+        fwrite(text, 1, length, stdout);
+        return;
+    }
+
+    memcpy(CONSOLE_BUFFER + console_length, text, length);
+    console_length += length;
+}
@@ -0,0 +1,54 @@
+/**
+ * @file console.h
+ * @author Kudryashov Ilya (kudriashov.it@phystech.edu)
+ * @brief Buffered console output of the processor.
+ * @version 0.1
+ * @date 2022-11-15
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+#include <stdlib.h>
+
+/**
+ * @brief Put characters into the console buffer.
+ *
+ * @param text characters to write
+ * @param length number of characters
+ */
+void console_write(const char* text, size_t length);
+
+/**
+ * @brief Put character into the console buffer.
+ *
+ * @param character character to write
+ */
+void console_put_char(char character);
+
+/**
+ * @brief Put decimal representation of the number into the console buffer.
+ *
+ * @param value number to write
+ */
+void console_put_int(long long value);
+
+/**
+ * @brief Put characters stored in consecutive cells into the console buffer.
+ *
+ * @param cells cells with character codes
+ * @param count number of cells
+ */
+void console_put_cells(const int* cells, size_t count);
+
+/**
+ * @brief Write buffered characters to stdout.
+ * 
+ * Should be called before reading input, clearing the screen and exiting.
+ */
+void console_flush();
+
+#endif
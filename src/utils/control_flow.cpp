@@ -0,0 +1,480 @@
+#include "control_flow.h"
+
+#include <string.h>
+
+#include "lib/util/dbg/debug.h"
+#include "src/proccmd.h"
+
+//* warning: stack protector not protecting function: all local arrays are less than 8 bytes long [-Wstack-protector]
+#pragma GCC diagnostic ignored "-Wstack-protector"
+
+//* Offset marks used while splitting the code into blocks.
+enum OffsetMark {
+    MARK_COMMAND = 1 << 0,  //* Command starts at the offset.
+    MARK_LEADER  = 1 << 1,  //* Block starts at the offset.
+    MARK_JUMPED  = 1 << 2,  //* Offset is a jump target.
+    MARK_CALLED  = 1 << 3,  //* Offset is a call target.
+};
+
+//* Number of colors in the DOT color scheme used to shade loops.
+static const size_t LOOP_SHADES = 9;
+
+/**
+ * @brief Get offset the branch command jumps to.
+ *
+ * @param content program image
+ * @param offset offset of the branch command
+ * @return long long jump target offset
+ */
+static long long get_target(const char* content, size_t offset);
+
+/**
+ * @brief Mark command starts, block starts and jump targets.
+ *
+ * @param content program image
+ * @param flow graph with code_begin and code_end set, code_end is cut at the first invalid command
+ * @param marks OffsetMark combinations by offset
+ */
+static void mark_offsets(const char* content, ControlFlow* flow, unsigned char* marks);
+
+/**
+ * @brief Fill successors and callees of the blocks.
+ *
+ * @param content program image
+ * @param flow graph with blocks and block ids set
+ * @param last_commands offsets of the last commands of the blocks
+ */
+static void link_blocks(const char* content, ControlFlow* flow, const size_t* last_commands);
+
+/**
+ * @brief Mark blocks reachable from the program start.
+ *
+ * @param flow control flow graph
+ * @param stack buffer of block_count elements
+ */
+static void mark_reachable(ControlFlow* flow, size_t* stack);
+
+/**
+ * @brief Find loop headers and loop depths of reachable blocks.
+ *
+ * @param flow control flow graph with reachable blocks marked
+ * @param err_code variable to use as errno
+ */
+static void find_loops(ControlFlow* flow, int* const err_code);
+
+void ControlFlow_dtor(ControlFlow* flow) {
+    if (flow->blocks) free(flow->blocks);
+    if (flow->block_ids) free(flow->block_ids);
+    *flow = {};
+}
+
+void build_control_flow(const char* content, size_t code_begin, size_t code_end, ControlFlow* flow, int* const err_code) {
+    _LOG_FAIL_CHECK_(content && flow, "error", ERROR_REPORTS, return, err_code, EFAULT);
+
+    *flow = {};
+    flow->code_begin = code_begin;
+    flow->code_end = code_end;
+
+    unsigned char* marks = (unsigned char*) calloc(code_end + 1, sizeof(*marks));
+    flow->block_ids = (size_t*) calloc(code_end + 1, sizeof(*flow->block_ids));
+    _LOG_FAIL_CHECK_(marks && flow->block_ids, "error", ERROR_REPORTS, {
+        if (marks) free(marks);
+        ControlFlow_dtor(flow);
+        return;
+    }, err_code, ENOMEM);
+
+    memset(flow->block_ids, 0xFF, (code_end + 1) * sizeof(*flow->block_ids));
+
+    mark_offsets(content, flow, marks);
+
+    for (size_t offset = flow->code_begin; offset < flow->code_end; ++offset) {
+        if ((marks[offset] & MARK_COMMAND) && (marks[offset] & (MARK_LEADER | MARK_JUMPED | MARK_CALLED))) {
+            ++flow->block_count;
+        }
+    }
+
+    flow->blocks = (CodeBlock*) calloc(flow->block_count + 1, sizeof(*flow->blocks));
+    size_t* last_commands = (size_t*) calloc(flow->block_count + 1, sizeof(*last_commands));
+    _LOG_FAIL_CHECK_(flow->blocks && last_commands, "error", ERROR_REPORTS, {
+        free(marks);
+        if (last_commands) free(last_commands);
+        ControlFlow_dtor(flow);
+        return;
+    }, err_code, ENOMEM);
+
+    size_t block_id = NO_BLOCK;
+    for (size_t offset = flow->code_begin; offset < flow->code_end; offset += (size_t)cmd_length((unsigned char)content[offset] >> 2)) {
+        if (marks[offset] & (MARK_LEADER | MARK_JUMPED | MARK_CALLED)) {
+            flow->blocks[++block_id] = {};
+            flow->blocks[block_id].begin = (uint32_t)offset;
+            flow->blocks[block_id].jump_target = (marks[offset] & MARK_JUMPED) != 0;
+            flow->blocks[block_id].call_target = (marks[offset] & MARK_CALLED) != 0;
+            flow->block_ids[offset] = block_id;
+        }
+
+        CodeBlock* block = &flow->blocks[block_id];
+        block->end = (uint32_t)(offset + (size_t)cmd_length((unsigned char)content[offset] >> 2));
+        ++block->command_count;
+        last_commands[block_id] = offset;
+    }
+
+    free(marks);
+
+    link_blocks(content, flow, last_commands);
+    mark_reachable(flow, last_commands);
+
+    free(last_commands);
+
+    find_loops(flow, err_code);
+}
+
+const CodeBlock* get_block(const ControlFlow* flow, size_t offset) {
+    if (!flow || !flow->block_ids || offset < flow->code_begin || offset >= flow->code_end) return NULL;
+
+    size_t block_id = flow->block_ids[offset];
+    return block_id == NO_BLOCK ? NULL : &flow->blocks[block_id];
+}
+
+void print_block_name(FILE* output, const CodeBlock* block, const DebugInfo* info) {
+    const DebugLabel* label = find_label(info, block->begin);
+
+    if (label && label->point == block->begin) fprintf(output, "%.*s", (int)label->name_length, label->name);
+    else fprintf(output, "%s%04X", block->call_target ? "sub_" : "loc_", block->begin);
+}
+
+void write_flow_graph(FILE* output, const ControlFlow* flow, const DebugInfo* info) {
+    fprintf(output, "digraph program {\n");
+    fprintf(output, "    node [shape=box, fontname=\"monospace\", style=filled, colorscheme=blues%lu];\n\n", LOOP_SHADES);
+
+    for (size_t block_id = 0; block_id < flow->block_count; ++block_id) {
+        const CodeBlock* block = &flow->blocks[block_id];
+
+        fprintf(output, "    b%lu [label=\"", block_id);
+        if (block->jump_target || block->call_target || block_id == 0) print_block_name(output, block, info);
+        else fprintf(output, "block %lu", block_id);
+
+        fprintf(output, "\\n0x%04X-0x%04X\\n%lu commands, %u bytes\\nloop depth %lu\"",
+                block->begin, block->end, block->command_count, block->end - block->begin, block->loop_depth);
+
+        size_t shade = block->loop_depth + 1 < LOOP_SHADES ? block->loop_depth + 1 : LOOP_SHADES;
+        fprintf(output, ", fillcolor=%lu%s%s];\n", shade, block->loop_header ? ", penwidth=2" : "",
+                                                   block->reachable ? "" : ", style=\"filled,dashed\"");
+    }
+
+    fputc('\n', output);
+
+    for (size_t block_id = 0; block_id < flow->block_count; ++block_id) {
+        const CodeBlock* block = &flow->blocks[block_id];
+
+        for (size_t succ_id = 0; succ_id < block->successor_count; ++succ_id) {
+            fprintf(output, "    b%lu -> b%lu;\n", block_id, block->successors[succ_id]);
+        }
+
+        if (block->callee != NO_BLOCK) fprintf(output, "    b%lu -> b%lu [style=dashed];\n", block_id, block->callee);
+    }
+
+    fprintf(output, "}\n");
+}
+
+static long long get_target(const char* content, size_t offset) {
+    unsigned int cmd_id = (unsigned char)content[offset] >> 2;
+
+    int distance = 0;
+    memcpy(&distance, content + offset + CMD_HEADER_SIZE + CMD_INFO[cmd_id].arg_size - sizeof(distance), sizeof(distance));
+
+    return (long long)offset + distance;
+}
+
+static void mark_offsets(const char* content, ControlFlow* flow, unsigned char* marks) {
+    //* Commands are decoded from the start, code after an unknown command does not belong to any block.
+    size_t offset = flow->code_begin;
+    while (offset < flow->code_end) {
+        size_t length = (size_t)cmd_length((unsigned char)content[offset] >> 2);
+        if (length == 0 || offset + length > flow->code_end) break;
+
+        marks[offset] |= MARK_COMMAND;
+        offset += length;
+    }
+    flow->code_end = offset;
+
+    marks[flow->code_begin] |= MARK_LEADER;
+
+    for (offset = flow->code_begin; offset < flow->code_end;) {
+        unsigned int flags = CMD_INFO[(unsigned char)content[offset] >> 2].flags;
+
+        if (flags & CMD_F_BRANCH) {
+            long long target = get_target(content, offset);
+
+            if (target >= (long long)flow->code_begin && target < (long long)flow->code_end &&
+                (marks[target] & MARK_COMMAND)) {
+                marks[target] |= (flags & CMD_F_CALL) ? MARK_CALLED : MARK_JUMPED;
+            }
+        }
+
+        offset += (size_t)cmd_length((unsigned char)content[offset] >> 2);
+
+        if (flags & (CMD_F_BRANCH | CMD_F_TERMINATOR)) marks[offset] |= MARK_LEADER;
+    }
+}
+
+static void link_blocks(const char* content, ControlFlow* flow, const size_t* last_commands) {
+    for (size_t block_id = 0; block_id < flow->block_count; ++block_id) {
+        CodeBlock* block = &flow->blocks[block_id];
+        size_t last = last_commands[block_id];
+        unsigned int flags = CMD_INFO[(unsigned char)content[last] >> 2].flags;
+
+        if (flags & CMD_F_BRANCH) {
+            long long target = get_target(content, last);
+
+            size_t target_id = target >= (long long)flow->code_begin && target < (long long)flow->code_end ?
+                               flow->block_ids[target] : NO_BLOCK;
+
+            if (target_id != NO_BLOCK && (flags & CMD_F_CALL)) block->callee = target_id;
+            else if (target_id != NO_BLOCK) block->successors[block->successor_count++] = target_id;
+        }
+
+        if (!(flags & CMD_F_TERMINATOR) && block->end < flow->code_end) {
+            block->successors[block->successor_count++] = flow->block_ids[block->end];
+        }
+    }
+}
+
+static void mark_reachable(ControlFlow* flow, size_t* stack) {
+    if (flow->block_count == 0) return;
+
+    size_t stack_size = 0;
+    stack[stack_size++] = 0;
+    flow->blocks[0].reachable = true;
+
+    while (stack_size) {
+        const CodeBlock* block = &flow->blocks[stack[--stack_size]];
+
+        size_t next[3] = { block->successors[0], block->successors[1], block->callee };
+        for (size_t next_id = 0; next_id < 3; ++next_id) {
+            if (next_id < 2 && next_id >= block->successor_count) continue;
+            if (next[next_id] == NO_BLOCK || flow->blocks[next[next_id]].reachable) continue;
+
+            flow->blocks[next[next_id]].reachable = true;
+            stack[stack_size++] = next[next_id];
+        }
+    }
+}
+
+/**
+ * @brief Dominator search state.
+ *
+ * Reachable blocks and a virtual root block_count, which precedes the program start and all called blocks.
+ *
+ * @param flow control flow graph
+ * @param roots program start and reachable called blocks
+ * @param root_count number of roots
+ * @param post postorder numbers of the blocks (NO_BLOCK - unreachable)
+ * @param idom immediate dominators of the blocks
+ * @param pred_start start of the predecessor list of every block in pred_list
+ * @param pred_list predecessors of all blocks
+ */
+struct DomTree {
+    const ControlFlow* flow = NULL;
+    size_t* roots = NULL;
+    size_t root_count = 0;
+    size_t* post = NULL;
+    size_t* idom = NULL;
+    size_t* pred_start = NULL;
+    size_t* pred_list = NULL;
+};
+
+/**
+ * @brief Get block execution continues in (including the edges from the virtual root).
+ *
+ * @param tree dominator search state
+ * @param block_id block id
+ * @param index successor index
+ * @return size_t successor (NO_BLOCK if there are no more)
+ */
+static size_t get_successor(const DomTree* tree, size_t block_id, size_t index) {
+    const ControlFlow* flow = tree->flow;
+
+    if (block_id < flow->block_count) {
+        return index < flow->blocks[block_id].successor_count ? flow->blocks[block_id].successors[index] : NO_BLOCK;
+    }
+
+    return index < tree->root_count ? tree->roots[index] : NO_BLOCK;
+}
+
+/**
+ * @brief Find the closest common dominator of two blocks.
+ *
+ * @param tree dominator search state
+ * @param alpha
+ * @param beta
+ * @return size_t
+ */
+static size_t intersect(const DomTree* tree, size_t alpha, size_t beta) {
+    while (alpha != beta) {
+        while (tree->post[alpha] < tree->post[beta]) alpha = tree->idom[alpha];
+        while (tree->post[beta] < tree->post[alpha]) beta = tree->idom[beta];
+    }
+    return alpha;
+}
+
+/**
+ * @brief Check if the block dominates another block.
+ *
+ * @param tree dominator search state with dominators found
+ * @param dominator
+ * @param block_id
+ * @return true if every path from the virtual root to block_id passes through dominator
+ */
+static bool dominates(const DomTree* tree, size_t dominator, size_t block_id) {
+    size_t root = tree->flow->block_count;
+
+    while (block_id != dominator && block_id != root) block_id = tree->idom[block_id];
+
+    return block_id == dominator;
+}
+
+static void find_loops(ControlFlow* flow, int* const err_code) {
+    size_t node_count = flow->block_count + 1, root = flow->block_count;
+
+    DomTree tree = {};
+    tree.flow = flow;
+    tree.roots = (size_t*) calloc(node_count, sizeof(*tree.roots));
+    tree.post = (size_t*) calloc(node_count, sizeof(*tree.post));
+    tree.idom = (size_t*) calloc(node_count, sizeof(*tree.idom));
+    tree.pred_start = (size_t*) calloc(node_count + 1, sizeof(*tree.pred_start));
+    tree.pred_list = (size_t*) calloc(3 * node_count, sizeof(*tree.pred_list));
+    size_t* order = (size_t*) calloc(node_count, sizeof(*order));
+    size_t* stack = (size_t*) calloc(2 * node_count, sizeof(*stack));
+
+    _LOG_FAIL_CHECK_(tree.roots && tree.post && tree.idom && tree.pred_start && tree.pred_list && order && stack,
+                     "error", ERROR_REPORTS, {
+        if (tree.roots) free(tree.roots);
+        if (tree.post) free(tree.post);
+        if (tree.idom) free(tree.idom);
+        if (tree.pred_start) free(tree.pred_start);
+        if (tree.pred_list) free(tree.pred_list);
+        if (order) free(order);
+        if (stack) free(stack);
+        return;
+    }, err_code, ENOMEM);
+
+    for (size_t node = 0; node < node_count; ++node) tree.post[node] = tree.idom[node] = NO_BLOCK;
+
+    //* Virtual root precedes the program start and every reachable called block.
+    for (size_t block_id = 0; block_id < flow->block_count; ++block_id) {
+        const CodeBlock* block = &flow->blocks[block_id];
+        if (block->reachable && (block_id == 0 || block->call_target)) tree.roots[tree.root_count++] = block_id;
+    }
+
+    //* Depth-first search from the virtual root numbering blocks in postorder. Stack holds {block, next successor} pairs.
+    size_t order_size = 0, stack_size = 0;
+    stack[stack_size++] = root;
+    stack[stack_size++] = 0;
+    tree.idom[root] = root;
+
+    while (stack_size) {
+        size_t node = stack[stack_size - 2];
+        size_t next = get_successor(&tree, node, stack[stack_size - 1]++);
+
+        if (next == NO_BLOCK) {
+            tree.post[node] = order_size;
+            order[order_size++] = node;
+            stack_size -= 2;
+        } else if (tree.idom[next] == NO_BLOCK) {
+            //* Dominator is set temporarily to mark visited blocks.
+            tree.idom[next] = root;
+            stack[stack_size++] = next;
+            stack[stack_size++] = 0;
+        }
+    }
+
+    for (size_t order_id = 0; order_id < order_size; ++order_id) {
+        for (size_t index = 0, next = 0; (next = get_successor(&tree, order[order_id], index)) != NO_BLOCK; ++index) {
+            ++tree.pred_start[next + 1];
+        }
+    }
+    for (size_t node = 0; node < node_count; ++node) tree.pred_start[node + 1] += tree.pred_start[node];
+
+    //* Stack is reused as the number of predecessors already put into the list.
+    memset(stack, 0, node_count * sizeof(*stack));
+
+    for (size_t order_id = 0; order_id < order_size; ++order_id) {
+        for (size_t index = 0, next = 0; (next = get_successor(&tree, order[order_id], index)) != NO_BLOCK; ++index) {
+            tree.pred_list[tree.pred_start[next] + stack[next]++] = order[order_id];
+        }
+    }
+
+    //* Iterative dominator search (Cooper, Harvey, Kennedy), blocks are processed in reverse postorder.
+    for (size_t node = 0; node < root; ++node) tree.idom[node] = NO_BLOCK;
+
+    for (bool changed = true; changed;) {
+        changed = false;
+
+        for (size_t order_id = order_size - 1; order_id-- > 0;) {
+            size_t node = order[order_id], new_idom = NO_BLOCK;
+
+            for (size_t pred_id = tree.pred_start[node]; pred_id < tree.pred_start[node + 1]; ++pred_id) {
+                size_t pred = tree.pred_list[pred_id];
+                if (tree.idom[pred] == NO_BLOCK) continue;
+
+                new_idom = new_idom == NO_BLOCK ? pred : intersect(&tree, pred, new_idom);
+            }
+
+            if (tree.idom[node] != new_idom) {
+                tree.idom[node] = new_idom;
+                changed = true;
+            }
+        }
+    }
+
+    //* Natural loop of the header consists of blocks reaching its back edges without passing the header.
+    size_t* loop_marks = order;
+    for (size_t node = 0; node < node_count; ++node) loop_marks[node] = NO_BLOCK;
+
+    for (size_t header = 0; header < root; ++header) {
+        if (tree.post[header] == NO_BLOCK) continue;
+
+        stack_size = 0;
+        loop_marks[header] = header;
+
+        bool has_back_edge = false;
+        for (size_t pred_id = tree.pred_start[header]; pred_id < tree.pred_start[header + 1]; ++pred_id) {
+            size_t tail = tree.pred_list[pred_id];
+            if (tail == root || !dominates(&tree, header, tail)) continue;
+
+            has_back_edge = true;
+            if (loop_marks[tail] == header) continue;
+
+            loop_marks[tail] = header;
+            stack[stack_size++] = tail;
+        }
+
+        if (!has_back_edge) continue;
+
+        flow->blocks[header].loop_header = true;
+
+        while (stack_size) {
+            size_t node = stack[--stack_size];
+
+            for (size_t pred_id = tree.pred_start[node]; pred_id < tree.pred_start[node + 1]; ++pred_id) {
+                size_t pred = tree.pred_list[pred_id];
+                if (pred == root || loop_marks[pred] == header) continue;
+
+                loop_marks[pred] = header;
+                stack[stack_size++] = pred;
+            }
+        }
+
+        for (size_t node = 0; node < root; ++node) {
+            if (loop_marks[node] == header) ++flow->blocks[node].loop_depth;
+        }
+    }
+
+    free(tree.roots);
+    free(tree.post);
+    free(tree.idom);
+    free(tree.pred_start);
+    free(tree.pred_list);
+    free(order);
+    free(stack);
+}
@@ -0,0 +1,118 @@
+/**
+ * @file control_flow.h
+ * @author Kudryashov Ilya (kudriashov.it@phystech.edu)
+ * @brief Recovery of basic blocks, jump labels and loops of the program code.
+ * @version 0.1
+ * @date 2022-11-11
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef CONTROL_FLOW_H
+#define CONTROL_FLOW_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "debug_info.h"
+
+//* Block id used for missing blocks.
+static const size_t NO_BLOCK = (size_t)-1;
+
+/**
+ * @brief Sequence of commands that is only entered at its first command and only left after its last one.
+ *
+ * @param begin offset of the first command
+ * @param end offset of the end of the last command
+ * @param command_count number of commands
+ * @param successors blocks execution can continue in (jump target first)
+ * @param successor_count number of successors
+ * @param callee block called by the last command (NO_BLOCK if it is not a call)
+ * @param loop_depth number of loops containing the block
+ * @param reachable true if the block can be reached from the program start
+ * @param loop_header true if the block is the entry of a loop
+ * @param jump_target true if the block is a target of a jump
+ * @param call_target true if the block is a target of a call
+ */
+struct CodeBlock {
+    uint32_t begin = 0;
+    uint32_t end = 0;
+    size_t command_count = 0;
+    size_t successors[2] = { NO_BLOCK, NO_BLOCK };
+    size_t successor_count = 0;
+    size_t callee = NO_BLOCK;
+    size_t loop_depth = 0;
+    bool reachable = false;
+    bool loop_header = false;
+    bool jump_target = false;
+    bool call_target = false;
+};
+
+/**
+ * @brief Control flow graph of the program code.
+ *
+ * @param blocks basic blocks sorted by offset
+ * @param block_count number of blocks
+ * @param block_ids ids of the blocks by offsets of their first commands (NO_BLOCK elsewhere)
+ * @param code_begin offset of the first command
+ * @param code_end offset of the end of the last valid command
+ */
+struct ControlFlow {
+    CodeBlock* blocks = NULL;
+    size_t block_count = 0;
+    size_t* block_ids = NULL;
+    size_t code_begin = 0;
+    size_t code_end = 0;
+};
+
+void ControlFlow_dtor(ControlFlow* flow);
+
+/**
+ * @brief Split the code into basic blocks and find reachable blocks and loops.
+ *
+ * Code is split into commands from its start, jumps to offsets other than command starts are ignored.
+ * Blocks are reached from the program start following jumps and calls, loops are natural loops of the back edges.
+ *
+ * @param content program image (offsets are counted from its start)
+ * @param code_begin offset of the first command
+ * @param code_end offset of the end of the code
+ * @param flow where to put the graph
+ * @param err_code variable to use as errno
+ */
+void build_control_flow(const char* content, size_t code_begin, size_t code_end, ControlFlow* flow,
+                        int* const err_code = NULL);
+
+/**
+ * @brief Get the block starting at the offset.
+ *
+ * @param flow control flow graph
+ * @param offset command offset
+ * @return const CodeBlock* block (NULL if no block starts at the offset)
+ */
+const CodeBlock* get_block(const ControlFlow* flow, size_t offset);
+
+/**
+ * @brief Print name of the label pointing at the block.
+ *
+ * Labels from the source map are used if there are any, names are made up from the offset otherwise.
+ *
+ * @param output file to print to
+ * @param block labeled block
+ * @param info source map (NULL - always make the name up)
+ */
+void print_block_name(FILE* output, const CodeBlock* block, const DebugInfo* info);
+
+/**
+ * @brief Write control flow graph in Graphviz DOT format.
+ *
+ * Blocks are annotated with their sizes and shaded by loop depth, call edges are dashed.
+ *
+ * @param output file to write to
+ * @param flow control flow graph
+ * @param info source map (NULL - label names are made up)
+ */
+void write_flow_graph(FILE* output, const ControlFlow* flow, const DebugInfo* info);
+
+#endif
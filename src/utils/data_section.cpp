@@ -0,0 +1,153 @@
+#include "data_section.h"
+
+#include <string.h>
+#include <stddef.h>
+#include <ctype.h>
+
+#include "lib/util/dbg/debug.h"
+
+/**
+ * @brief Read the next integer of directive arguments.
+ * 
+ * @param args pointer to the arguments, moved past the integer
+ * @param value where to put the integer
+ * @return true if the integer was read
+ */
+static bool read_data_value(const char** args, int* value);
+
+const char* read_data_block(const char* data, const char* end, DataBlock* block) {
+    if (data == NULL || end - data < (ptrdiff_t)sizeof(*block)) return NULL;
+
+    memcpy(block, data, sizeof(*block));
+    data += sizeof(*block);
+
+    if (block->address < 0 || block->length < 0) return NULL;
+    if ((size_t)(end - data) / sizeof(int) < (size_t)block->length) return NULL;
+
+    return data;
+}
+
+void load_data(const char* data, size_t data_size, MemorySegment* ram, int* const err_code) {
+    _LOG_FAIL_CHECK_(ram && ram->content, "error", ERROR_REPORTS, return, err_code, EFAULT);
+
+    const char* end = data + data_size;
+
+    while (data && data < end) {
+        DataBlock block = {};
+        const char* values = read_data_block(data, end, &block);
+
+        _LOG_FAIL_CHECK_(values, "error", ERROR_REPORTS, {
+            log_printf(ERROR_REPORTS, "error", "Data section is corrupt.\n");
+            return;
+        }, err_code, EIO);
+
+        _LOG_FAIL_CHECK_((size_t)block.address + (size_t)block.length <= ram->size, "error", ERROR_REPORTS, {
+            log_printf(ERROR_REPORTS, "error", "Data block of %d cells at RAM address %d does not fit into %lu RAM cells.\n",
+                                               block.length, block.address, ram->size);
+            return;
+        }, err_code, EFAULT);
+
+        if (block.length) memcpy(ram->content + block.address, values, (size_t)block.length * sizeof(int));
+
+        data = values + (size_t)block.length * sizeof(int);
+    }
+}
+
+
+
+void parse_data_directive(PseudoFile* data, DataDirective directive, const char* args, int* const err_code) {
+    _LOG_FAIL_CHECK_(data && args, "error", ERROR_REPORTS, return, err_code, EFAULT);
+
+    DataBlock block = {};
+
+    _LOG_FAIL_CHECK_(read_data_value(&args, &block.address) && block.address >= 0, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Data directive \"%s\" should start with a non-negative RAM address.\n", args);
+        return;
+    }, err_code, EINVAL);
+
+    size_t block_start = data->size;
+    PseudoFile_append(data, &block, sizeof(block), err_code);
+
+    int value = 0;
+
+    if (directive == DATA_STRING) {
+        while (isspace(*args)) ++args;
+
+        _LOG_FAIL_CHECK_(*args == '"', "error", ERROR_REPORTS, {
+            log_printf(ERROR_REPORTS, "error", "STRING text should be written in double quotes.\n");
+            data->size = block_start;
+            return;
+        }, err_code, EINVAL);
+
+        for (++args; *args && *args != '"'; ++args, ++block.length) {
+            value = (unsigned char)*args;
+
+            if (*args == '\\' && args[1]) switch (*++args) {
+                case 'n': value = '\n'; break;
+                case 't': value = '\t'; break;
+                case '0': value = '\0'; break;
+                default:  value = (unsigned char)*args; break;
+            }
+
+            PseudoFile_append(data, &value, sizeof(value), err_code);
+        }
+
+        _LOG_FAIL_CHECK_(*args == '"', "error", ERROR_REPORTS, {
+            log_printf(ERROR_REPORTS, "error", "STRING text is missing its closing quote.\n");
+            data->size = block_start;
+            return;
+        }, err_code, EINVAL);
+
+        ++args;
+
+        //* Strings are NUL-terminated.
+        value = 0;
+        PseudoFile_append(data, &value, sizeof(value), err_code);
+        ++block.length;
+
+    } else if (directive == DATA_FILL) {
+        int count = 0;
+
+        _LOG_FAIL_CHECK_(read_data_value(&args, &count) && count >= 0 && read_data_value(&args, &value),
+                         "error", ERROR_REPORTS, {
+            log_printf(ERROR_REPORTS, "error", "FILL expects address, non-negative cell count and value.\n");
+            data->size = block_start;
+            return;
+        }, err_code, EINVAL);
+
+        PseudoFile_reserve(data, (size_t)count * sizeof(value), err_code);
+        _LOG_FAIL_CHECK_(data->size + (size_t)count * sizeof(value) <= data->capacity, "error", ERROR_REPORTS, {
+            data->size = block_start;
+            return;
+        }, err_code, ENOMEM);
+
+        for (block.length = 0; block.length < count; ++block.length) {
+            PseudoFile_append(data, &value, sizeof(value), err_code);
+        }
+
+    } else {
+        for (; read_data_value(&args, &value); ++block.length) {
+            PseudoFile_append(data, &value, sizeof(value), err_code);
+        }
+    }
+
+    while (isspace(*args)) ++args;
+    _LOG_FAIL_CHECK_(*args == '\0' || *args == '#', "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Unexpected data directive argument \"%s\".\n", args);
+        data->size = block_start;
+        return;
+    }, err_code, EINVAL);
+
+    _LOG_FAIL_CHECK_(data->content, "error", ERROR_REPORTS, return, err_code, ENOMEM);
+    memcpy(data->content + block_start, &block, sizeof(block));
+}
+
+static bool read_data_value(const char** args, int* value) {
+    char* end = NULL;
+    long parsed = strtol(*args, &end, 0);
+    if (end == *args) return false;
+
+    *value = (int)parsed;
+    *args = end;
+    return true;
+}
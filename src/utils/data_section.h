@@ -0,0 +1,67 @@
+/**
+ * @file data_section.h
+ * @author Kudryashov Ilya (kudriashov.it@phystech.edu)
+ * @brief Initial RAM contents stored in program binaries.
+ * @version 0.1
+ * @date 2022-11-06
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#ifndef DATA_SECTION_H
+#define DATA_SECTION_H
+
+#include <stdlib.h>
+
+#include "common.h"
+
+/**
+ * @brief Header of the data block, followed by length integers to put into RAM.
+ * 
+ * @param address RAM cell of the first value
+ * @param length number of values
+ */
+struct DataBlock {
+    int address = 0;
+    int length = 0;
+};
+
+//* Data section directives of the assembler.
+enum DataDirective {
+    DATA_VALUES,  // DATA address values...
+    DATA_FILL,    // FILL address count value
+    DATA_STRING,  // STRING address "text"
+};
+
+/**
+ * @brief Parse data directive arguments and append the resulting block to the data section.
+ * 
+ * @param data data section to append the block to
+ * @param directive directive type
+ * @param args NUL-terminated directive arguments starting with the RAM address
+ * @param err_code variable to use as errno
+ */
+void parse_data_directive(PseudoFile* data, DataDirective directive, const char* args, int* const err_code = NULL);
+
+/**
+ * @brief Get the next data block of the section.
+ * 
+ * @param data pointer to the block header
+ * @param end end of the data section
+ * @param block where to put the block header
+ * @return const char* pointer to the block values (NULL if the block does not fit into the section)
+ */
+const char* read_data_block(const char* data, const char* end, DataBlock* block);
+
+/**
+ * @brief Copy all blocks of the data section into RAM.
+ * 
+ * @param data start of the data section
+ * @param data_size size of the data section
+ * @param ram RAM to fill
+ * @param err_code variable to use as errno
+ */
+void load_data(const char* data, size_t data_size, MemorySegment* ram, int* const err_code = NULL);
+
+#endif
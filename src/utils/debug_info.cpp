@@ -0,0 +1,204 @@
+#include "debug_info.h"
+
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "lib/util/dbg/debug.h"
+#include "lib/file_proc.h"
+
+//* warning: stack protector not protecting function: all local arrays are less than 8 bytes long [-Wstack-protector]
+#pragma GCC diagnostic ignored "-Wstack-protector"
+
+/**
+ * @brief Source map file header.
+ *
+ * Header is followed by NUL-terminated source name padded to 4 bytes, line table and label records.
+ *
+ * @param prefix source map prefix (DEBUG_INFO_PREFIX)
+ * @param version source map format version
+ * @param source_length length of the source name
+ * @param line_count number of line mappings
+ * @param label_count number of label records
+ */
+struct DebugInfoHeader {
+    char prefix[4] = {};
+    version_t version = DEBUG_INFO_VERSION;
+    uint32_t source_length = 0;
+    uint32_t line_count = 0;
+    uint32_t label_count = 0;
+};
+
+static const size_t DEBUG_INFO_ALIGNMENT = 4;
+
+/**
+ * @brief Round size up to the record alignment.
+ *
+ * @param size
+ * @return size_t
+ */
+static size_t align_size(size_t size);
+
+/**
+ * @brief Validate source map content and fill the lists.
+ *
+ * @param name source map name to use in messages
+ * @param info source map with content set
+ * @param size content size
+ * @param err_code variable to use as errno
+ */
+static void parse_debug_info(const char* name, DebugInfo* info, size_t size, int* const err_code);
+
+void DebugInfo_dtor(DebugInfo* info) {
+    if (info->content) free(info->content);
+    if (info->labels) free(info->labels);
+    *info = {};
+}
+
+void write_debug_info(FILE* output, const char* source, const LineMapping* lines, size_t line_count,
+                      const char* labels, size_t labels_size, size_t label_count, int* const err_code) {
+    _LOG_FAIL_CHECK_(output && source, "error", ERROR_REPORTS, return, err_code, EFAULT);
+
+    static const char padding[DEBUG_INFO_ALIGNMENT] = {};
+
+    DebugInfoHeader header = {};
+    memcpy(header.prefix, DEBUG_INFO_PREFIX, sizeof(header.prefix));
+    header.source_length = (uint32_t)strlen(source);
+    header.line_count    = (uint32_t)line_count;
+    header.label_count   = (uint32_t)label_count;
+
+    fwrite(&header, sizeof(header), 1, output);
+    fwrite(source, sizeof(char), header.source_length, output);
+    fwrite(padding, sizeof(char), align_size(header.source_length + 1) - header.source_length, output);
+
+    if (line_count) fwrite(lines, sizeof(*lines), line_count, output);
+    if (labels_size) fwrite(labels, sizeof(char), labels_size, output);
+}
+
+void read_debug_info(const char* file_name, DebugInfo* info, int* const err_code) {
+    _LOG_FAIL_CHECK_(file_name && info, "error", ERROR_REPORTS, return, err_code, EFAULT);
+
+    int fd = open(file_name, O_RDONLY);
+    _LOG_FAIL_CHECK_(fd != -1, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Failed to open source map %s.\n", file_name);
+        return;
+    }, err_code, ENOENT);
+
+    size_t size = flength(fd);
+    info->content = (char*) calloc(size + 1, sizeof(*info->content));
+    _LOG_FAIL_CHECK_(info->content, "error", ERROR_REPORTS, {
+        close(fd);
+        return;
+    }, err_code, ENOMEM);
+
+    ssize_t read_size = read(fd, info->content, size);
+    close(fd);
+
+    _LOG_FAIL_CHECK_(read_size >= 0 && (size_t)read_size == size, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Failed to read source map %s.\n", file_name);
+        DebugInfo_dtor(info);
+        return;
+    }, err_code, EIO);
+
+    parse_debug_info(file_name, info, size, err_code);
+}
+
+void load_debug_info(const char* content, size_t size, DebugInfo* info, int* const err_code) {
+    _LOG_FAIL_CHECK_(content && info, "error", ERROR_REPORTS, return, err_code, EFAULT);
+
+    info->content = (char*) calloc(size + 1, sizeof(*info->content));
+    _LOG_FAIL_CHECK_(info->content, "error", ERROR_REPORTS, return, err_code, ENOMEM);
+
+    memcpy(info->content, content, size);
+
+    parse_debug_info("embedded into the binary", info, size, err_code);
+}
+
+static void parse_debug_info(const char* name, DebugInfo* info, size_t size, int* const err_code) {
+    DebugInfoHeader header = {};
+    if (size >= sizeof(header)) memcpy(&header, info->content, sizeof(header));
+
+    size_t lines_offset = sizeof(header) + align_size((size_t)header.source_length + 1);
+    size_t labels_offset = lines_offset + header.line_count * sizeof(LineMapping);
+
+    _LOG_FAIL_CHECK_(strncmp(header.prefix, DEBUG_INFO_PREFIX, sizeof(header.prefix)) == 0 &&
+                     header.version == DEBUG_INFO_VERSION && labels_offset <= size, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Source map %s is not a version %d source map.\n", name, DEBUG_INFO_VERSION);
+        DebugInfo_dtor(info);
+        return;
+    }, err_code, EIO);
+
+    info->labels = (DebugLabel*) calloc(header.label_count + 1, sizeof(*info->labels));
+    _LOG_FAIL_CHECK_(info->labels, "error", ERROR_REPORTS, {
+        DebugInfo_dtor(info);
+        return;
+    }, err_code, ENOMEM);
+
+    const char* record = info->content + labels_offset;
+    for (size_t label_id = 0; label_id < header.label_count; ++label_id) {
+        DebugLabel* label = &info->labels[label_id];
+
+        _LOG_FAIL_CHECK_((size_t)(info->content + size - record) >= 2 * sizeof(uint32_t), "error", ERROR_REPORTS, {
+            DebugInfo_dtor(info);
+            return;
+        }, err_code, EIO);
+
+        memcpy(&label->point, record, sizeof(label->point));
+        memcpy(&label->name_length, record + sizeof(uint32_t), sizeof(label->name_length));
+        label->name = record + 2 * sizeof(uint32_t);
+
+        _LOG_FAIL_CHECK_(label->name_length <= (size_t)(info->content + size - label->name), "error", ERROR_REPORTS, {
+            log_printf(ERROR_REPORTS, "error", "Source map %s is truncated.\n", name);
+            DebugInfo_dtor(info);
+            return;
+        }, err_code, EIO);
+
+        record = label->name + align_size(label->name_length);
+        if (record > info->content + size) record = info->content + size;
+    }
+
+    info->source = info->content + sizeof(header);
+    info->lines = (const LineMapping*)(info->content + lines_offset);
+    info->line_count = header.line_count;
+    info->label_count = header.label_count;
+}
+
+const LineMapping* find_line(const DebugInfo* info, uint32_t offset) {
+    if (!info || !info->line_count || info->lines[0].offset > offset) return NULL;
+
+    size_t left = 0, right = info->line_count;
+    while (right - left > 1) {
+        size_t middle = (left + right) / 2;
+        if (info->lines[middle].offset <= offset) left = middle;
+        else right = middle;
+    }
+
+    return &info->lines[left];
+}
+
+const DebugLabel* find_label(const DebugInfo* info, uint32_t offset) {
+    if (!info || !info->label_count || info->labels[0].point > offset) return NULL;
+
+    size_t left = 0, right = info->label_count;
+    while (right - left > 1) {
+        size_t middle = (left + right) / 2;
+        if (info->labels[middle].point <= offset) left = middle;
+        else right = middle;
+    }
+
+    return &info->labels[left];
+}
+
+void print_location(FILE* output, const DebugInfo* info, uint32_t offset) {
+    const LineMapping* line = find_line(info, offset);
+    const DebugLabel* label = find_label(info, offset);
+
+    if (line) fprintf(output, "%s:%u", info->source, line->line);
+    else fprintf(output, "0x%0*X", (int)sizeof(uintptr_t), offset);
+
+    if (label) fprintf(output, " (%.*s+%u)", (int)label->name_length, label->name, offset - label->point);
+}
+
+static size_t align_size(size_t size) {
+    return (size + DEBUG_INFO_ALIGNMENT - 1) / DEBUG_INFO_ALIGNMENT * DEBUG_INFO_ALIGNMENT;
+}
@@ -0,0 +1,132 @@
+/**
+ * @file debug_info.h
+ * @author Kudryashov Ilya (kudriashov.it@phystech.edu)
+ * @brief Source maps linking binary code offsets to source lines and labels.
+ * @version 0.1
+ * @date 2022-11-07
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef DEBUG_INFO_H
+#define DEBUG_INFO_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "src/procinfo.h"
+
+static const char DEBUG_INFO_PREFIX[] = "KITd";
+const version_t DEBUG_INFO_VERSION = 1;
+
+/**
+ * @brief Source line of the instruction.
+ *
+ * @param offset instruction offset in the binary (header included, as in listings and processor logs)
+ * @param line source line number starting from 1
+ */
+struct LineMapping {
+    uint32_t offset = 0;
+    uint32_t line = 0;
+};
+
+/**
+ * @brief Code label with its name.
+ *
+ * @param point label offset in the binary
+ * @param name label name (not NUL-terminated)
+ * @param name_length length of the name
+ */
+struct DebugLabel {
+    uint32_t point = 0;
+    const char* name = NULL;
+    uint32_t name_length = 0;
+};
+
+/**
+ * @brief Source map loaded from the file.
+ *
+ * @param content file content
+ * @param source name of the source file (NUL-terminated)
+ * @param lines instruction lines sorted by offset
+ * @param line_count number of instruction lines
+ * @param labels labels sorted by offset
+ * @param label_count number of labels
+ */
+struct DebugInfo {
+    char* content = NULL;
+    const char* source = "";
+    const LineMapping* lines = NULL;
+    size_t line_count = 0;
+    DebugLabel* labels = NULL;
+    size_t label_count = 0;
+};
+
+void DebugInfo_dtor(DebugInfo* info);
+
+/**
+ * @brief Write source map to the file.
+ *
+ * Labels are stored as sequence of {uint32_t point, uint32_t name_length, name} records.
+ *
+ * @param output file to write to
+ * @param source name of the source file
+ * @param lines instruction lines sorted by offset
+ * @param line_count number of instruction lines
+ * @param labels label records sorted by offset
+ * @param labels_size byte size of label records
+ * @param label_count number of label records
+ * @param err_code variable to use as errno
+ */
+void write_debug_info(FILE* output, const char* source, const LineMapping* lines, size_t line_count,
+                      const char* labels, size_t labels_size, size_t label_count, int* const err_code = NULL);
+
+/**
+ * @brief Read and validate source map.
+ *
+ * @param file_name name of the source map file
+ * @param info where to put the source map
+ * @param err_code variable to use as errno
+ */
+void read_debug_info(const char* file_name, DebugInfo* info, int* const err_code = NULL);
+
+/**
+ * @brief Read and validate source map embedded into the binary.
+ *
+ * @param content source map content (copied)
+ * @param size source map size
+ * @param info where to put the source map
+ * @param err_code variable to use as errno
+ */
+void load_debug_info(const char* content, size_t size, DebugInfo* info, int* const err_code = NULL);
+
+/**
+ * @brief Find source line of the instruction.
+ *
+ * @param info source map
+ * @param offset instruction offset
+ * @return const LineMapping* line of the last instruction at or before the offset (NULL if there is none)
+ */
+const LineMapping* find_line(const DebugInfo* info, uint32_t offset);
+
+/**
+ * @brief Find the closest label at or before the offset.
+ *
+ * @param info source map
+ * @param offset code offset
+ * @return const DebugLabel* label (NULL if there is none)
+ */
+const DebugLabel* find_label(const DebugInfo* info, uint32_t offset);
+
+/**
+ * @brief Print offset as source location ("file:line (label+delta)").
+ *
+ * @param output file to print to
+ * @param info source map (NULL - print offset only)
+ * @param offset code offset
+ */
+void print_location(FILE* output, const DebugInfo* info, uint32_t offset);
+
+#endif
@@ -0,0 +1,80 @@
+#include <string.h>
+
+#include "lib/util/dbg/debug.h"
+
+#define PROCESSOR
+
+#include "frames.h"
+
+//* warning: stack protector not protecting function: all local arrays are less than 8 bytes long [-Wstack-protector]
+#pragma GCC diagnostic ignored "-Wstack-protector"
+
+void FrameStack_ctor(FrameStack* frames) {
+    frames->content = (stack_content_t*) calloc(FRAME_STACK_START_SIZE, sizeof(*frames->content));
+    frames->capacity = frames->content ? FRAME_STACK_START_SIZE : 0;
+    frames->size = 0;
+    frames->pointer = 0;
+}
+
+void FrameStack_dtor(FrameStack* frames) {
+    free(frames->content);
+    frames->content = NULL;
+    frames->capacity = 0;
+    frames->size = 0;
+    frames->pointer = 0;
+}
+
+bool frame_enter(FrameStack* frames, int local_count, int* const err_code) {
+    _LOG_FAIL_CHECK_(frames, "error", ERROR_REPORTS, return false, err_code, EFAULT);
+    _LOG_FAIL_CHECK_(local_count >= 0, "error", ERROR_REPORTS, return false, err_code, EINVAL);
+
+    size_t new_size = frames->size + (size_t)local_count + 1;
+
+    _LOG_FAIL_CHECK_(new_size <= MAX_FRAME_STACK_SIZE, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Frame stack overflow (%lu cells).\n", new_size);
+        return false;
+    }, err_code, ENOMEM);
+
+    if (new_size > frames->capacity) {
+        size_t capacity = frames->capacity ? frames->capacity : FRAME_STACK_START_SIZE;
+        while (capacity < new_size) capacity *= 2;
+
+        stack_content_t* content = (stack_content_t*) realloc(frames->content, capacity * sizeof(*content));
+        _LOG_FAIL_CHECK_(content, "error", ERROR_REPORTS, return false, err_code, ENOMEM);
+
+        frames->content = content;
+        frames->capacity = capacity;
+    }
+
+    frames->content[frames->size] = (stack_content_t)frames->pointer;
+    frames->pointer = frames->size + 1;
+    memset(frames->content + frames->pointer, 0, (size_t)local_count * sizeof(*frames->content));
+    frames->size = new_size;
+
+    return true;
+}
+
+bool frame_leave(FrameStack* frames, int* const err_code) {
+    _LOG_FAIL_CHECK_(frames, "error", ERROR_REPORTS, return false, err_code, EFAULT);
+
+    _LOG_FAIL_CHECK_(frames->pointer > 0, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "LEAVE without a frame.\n");
+        return false;
+    }, err_code, EFAULT);
+
+    frames->size = frames->pointer - 1;
+    frames->pointer = (size_t)frames->content[frames->size];
+
+    return true;
+}
+
+stack_content_t* frame_local(FrameStack* frames, int index, int* const err_code) {
+    _LOG_FAIL_CHECK_(frames, "error", ERROR_REPORTS, return NULL, err_code, EFAULT);
+
+    _LOG_FAIL_CHECK_(frames->pointer > 0 && index >= 0 && (size_t)index < frames->size - frames->pointer, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Local variable %d does not exist in the current frame.\n", index);
+        return NULL;
+    }, err_code, EFAULT);
+
+    return frames->content + frames->pointer + index;
+}
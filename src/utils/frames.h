@@ -0,0 +1,72 @@
+/**
+ * @file frames.h
+ * @author Kudryashov Ilya (kudriashov.it@phystech.edu)
+ * @brief Stack of local variable frames.
+ * @version 0.1
+ * @date 2022-11-15
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef FRAMES_H
+#define FRAMES_H
+
+#ifndef PROCESSOR
+    #error frames.h should only be included by the processor after its config.h.
+#endif
+
+#include <stdlib.h>
+
+#include "src/config.h"
+
+/**
+ * @brief Local variables of the called subroutines.
+ *
+ * Every frame starts with the position of the previous frame followed by its local variables.
+ *
+ * @param content frame cells
+ * @param size number of used cells
+ * @param capacity number of allocated cells
+ * @param pointer index of the first local variable of the current frame (0 if there are no frames)
+ */
+struct FrameStack {
+    stack_content_t* content = NULL;
+    size_t size = 0;
+    size_t capacity = 0;
+    size_t pointer = 0;
+};
+
+void FrameStack_ctor(FrameStack* frames);
+void FrameStack_dtor(FrameStack* frames);
+
+/**
+ * @brief Start new frame with zeroed local variables.
+ *
+ * @param frames frame stack
+ * @param local_count number of local variables
+ * @param err_code variable to use as errno
+ * @return true if the frame was created
+ */
+bool frame_enter(FrameStack* frames, int local_count, int* const err_code = NULL);
+
+/**
+ * @brief Remove current frame and return to the previous one.
+ *
+ * @param frames frame stack
+ * @param err_code variable to use as errno
+ * @return true if there was a frame to remove
+ */
+bool frame_leave(FrameStack* frames, int* const err_code = NULL);
+
+/**
+ * @brief Get local variable of the current frame.
+ *
+ * @param frames frame stack
+ * @param index variable index
+ * @param err_code variable to use as errno
+ * @return stack_content_t* local variable (NULL if the frame does not have it)
+ */
+stack_content_t* frame_local(FrameStack* frames, int index, int* const err_code = NULL);
+
+#endif
@@ -0,0 +1,207 @@
+#include "image_cache.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "lib/util/dbg/debug.h"
+
+//* warning: stack protector not protecting function: all local arrays are less than 8 bytes long [-Wstack-protector]
+#pragma GCC diagnostic ignored "-Wstack-protector"
+
+static const size_t MAX_IMAGE_PATH_LENGTH = 2048;
+
+/**
+ * @brief Get file name of the cached image.
+ *
+ * @param buffer buffer of MAX_IMAGE_PATH_LENGTH characters
+ * @param cache_dir cache directory
+ * @param key image key
+ * @return true if the name fits into the buffer
+ */
+static bool get_image_path(char* buffer, const char* cache_dir, hash_t key);
+
+/**
+ * @brief Hash content of the regular file.
+ *
+ * @param file_name name of the file
+ * @return hash_t content hash (0 if the file is not a regular file)
+ */
+static hash_t hash_file(const char* file_name);
+
+/**
+ * @brief Map cached image into memory (see load_image()).
+ *
+ * @param path image file name
+ * @param key hash of the original file
+ * @param stamp hash of the current processor build
+ * @param program where to put the program
+ * @return true if the image was loaded
+ */
+static bool map_image(const char* path, hash_t key, hash_t stamp, Program* program);
+
+/**
+ * @brief Write cached image (see save_image()).
+ *
+ * @param path image file name
+ * @param key hash of the original file
+ * @param stamp hash of the current processor build
+ * @param program verified program
+ */
+static void write_image(const char* path, hash_t key, hash_t stamp, const Program* program);
+
+//* Cache misses and failed system calls of the cache should not end up in the errno of the program.
+
+hash_t get_image_key(const char* file_name) {
+    if (!file_name) return 0;
+
+    int saved_errno = errno;
+    hash_t key = hash_file(file_name);
+    errno = saved_errno;
+
+    return key;
+}
+
+bool load_image(const char* cache_dir, hash_t key, hash_t stamp, Program* program) {
+    if (!cache_dir || !key || !program) return false;
+
+    char path[MAX_IMAGE_PATH_LENGTH] = "";
+    if (!get_image_path(path, cache_dir, key)) return false;
+
+    int saved_errno = errno;
+    bool loaded = map_image(path, key, stamp, program);
+    errno = saved_errno;
+
+    return loaded;
+}
+
+void save_image(const char* cache_dir, hash_t key, hash_t stamp, const Program* program) {
+    if (!cache_dir || !key || !program || !program->content) return;
+
+    char path[MAX_IMAGE_PATH_LENGTH] = "";
+    _LOG_FAIL_CHECK_(get_image_path(path, cache_dir, key), "warning", WARNINGS, return, NULL, 0);
+
+    int saved_errno = errno;
+    mkdir(cache_dir, 0755);
+    write_image(path, key, stamp, program);
+    errno = saved_errno;
+}
+
+static hash_t hash_file(const char* file_name) {
+    int fd = open(file_name, O_RDONLY);
+    if (fd == -1) return 0;
+
+    struct stat info = {};
+    fstat(fd, &info);
+
+    //* Streams can not be read twice, so only regular files are cached.
+    if (!S_ISREG(info.st_mode) || info.st_size <= 0) {
+        close(fd);
+        return 0;
+    }
+
+    void* mapping = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) return 0;
+
+    madvise(mapping, (size_t)info.st_size, MADV_SEQUENTIAL);
+    hash_t key = get_hash(mapping, (const char*)mapping + info.st_size);
+    munmap(mapping, (size_t)info.st_size);
+
+    return key ? key : 1;
+}
+
+static bool map_image(const char* path, hash_t key, hash_t stamp, Program* program) {
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) return false;
+
+    struct stat info = {};
+    fstat(fd, &info);
+
+    if (!S_ISREG(info.st_mode) || (size_t)info.st_size < HEADER_SIZE + sizeof(ImageTrailer)) {
+        close(fd);
+        return false;
+    }
+
+    void* mapping = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) return false;
+
+    ImageTrailer trailer = {};
+    memcpy(&trailer, (const char*)mapping + info.st_size - sizeof(trailer), sizeof(trailer));
+
+    if (strncmp(trailer.prefix, IMAGE_PREFIX, sizeof(trailer.prefix)) != 0 || trailer.version != IMAGE_VERSION ||
+        trailer.key != key || trailer.stamp != stamp) {
+        log_printf(WARNINGS, "warning", "Cached image %s is outdated, ignoring it.\n", path);
+        munmap(mapping, (size_t)info.st_size);
+        return false;
+    }
+
+    madvise(mapping, (size_t)info.st_size, MADV_WILLNEED);
+
+    program->file = (char*) mapping;
+    program->file_size = (size_t)info.st_size;
+    program->mapped = true;
+    program->content = program->file;
+    program->size = program->file_size - sizeof(trailer);
+
+    //* Section table is still checked, it costs nothing and keeps a damaged image from being run.
+    int err_code = 0;
+    read_sections(program, &err_code, true);
+    if (!program->content) return false;
+
+    program->version = trailer.program_version;
+
+    log_printf(STATUS_REPORTS, "status", "Loaded cached image %s.\n", path);
+
+    return true;
+}
+
+static void write_image(const char* path, hash_t key, hash_t stamp, const Program* program) {
+    char temp_path[MAX_IMAGE_PATH_LENGTH] = "";
+    _LOG_FAIL_CHECK_(snprintf(temp_path, sizeof(temp_path), "%s.%d", path, getpid()) < (int)sizeof(temp_path),
+                     "warning", WARNINGS, return, NULL, 0);
+
+    FILE* file = fopen(temp_path, "wb");
+    _LOG_FAIL_CHECK_(file, "warning", WARNINGS, {
+        log_printf(WARNINGS, "warning", "Failed to create cached image %s.\n", temp_path);
+        return;
+    }, NULL, 0);
+
+    BinSection sections[] = {
+        { SECTION_CODE,    program->content + HEADER_SIZE, program->code_end - HEADER_SIZE },
+        { SECTION_DATA,    program->data,                  program->data_size              },
+        { SECTION_SYMBOLS, program->symbols,               program->symbols_size           },
+        { SECTION_DEBUG,   program->debug,                 program->debug_size             },
+    };
+
+    int err_code = 0;
+    write_binary(file, sections, sizeof(sections) / sizeof(*sections), &err_code);
+
+    ImageTrailer trailer = {};
+    memcpy(trailer.prefix, IMAGE_PREFIX, sizeof(trailer.prefix));
+    trailer.program_version = program->version;
+    trailer.key = key;
+    trailer.stamp = stamp;
+
+    fwrite(&trailer, sizeof(trailer), 1, file);
+
+    bool written = !ferror(file) && err_code == 0;
+    if (fclose(file) != 0) written = false;
+
+    _LOG_FAIL_CHECK_(written && rename(temp_path, path) == 0, "warning", WARNINGS, {
+        log_printf(WARNINGS, "warning", "Failed to save cached image %s.\n", path);
+        remove(temp_path);
+        return;
+    }, NULL, 0);
+
+    log_printf(STATUS_REPORTS, "status", "Saved cached image %s.\n", path);
+}
+
+static bool get_image_path(char* buffer, const char* cache_dir, hash_t key) {
+    int length = snprintf(buffer, MAX_IMAGE_PATH_LENGTH, "%s/%016llX.img", cache_dir, key);
+    return length > 0 && (size_t)length < MAX_IMAGE_PATH_LENGTH;
+}
@@ -0,0 +1,80 @@
+/**
+ * @file image_cache.h
+ * @author Kudryashov Ilya (kudriashov.it@phystech.edu)
+ * @brief On-disk cache of verified and decoded program images.
+ * @version 0.1
+ * @date 2022-11-10
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef IMAGE_CACHE_H
+#define IMAGE_CACHE_H
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "lib/util/dbg/debug.h"
+#include "src/procinfo.h"
+#include "binfile.h"
+
+static const char IMAGE_PREFIX[] = "KITi";
+const version_t IMAGE_VERSION = 1;
+
+/**
+ * @brief Cached image trailer.
+ *
+ * Cached image is a current version binary with plain (not packed) code section followed by the trailer,
+ * so it can be mapped and used without decoding. Images are named after the hash of the original file.
+ *
+ * @param prefix image prefix (IMAGE_PREFIX)
+ * @param version image format version
+ * @param program_version format version of the original file
+ * @param reserved should be 0
+ * @param key hash of the original file
+ * @param stamp hash of the processor build that verified the image
+ */
+struct ImageTrailer {
+    char prefix[4] = {};
+    version_t version = IMAGE_VERSION;
+    version_t program_version = 0;
+    uint32_t reserved = 0;
+    hash_t key = 0;
+    hash_t stamp = 0;
+};
+
+/**
+ * @brief Calculate cache key of the binary file.
+ *
+ * @param file_name name of the binary file
+ * @return hash_t hash of the file content (0 if the file is not a regular file and can not be cached)
+ */
+hash_t get_image_key(const char* file_name);
+
+/**
+ * @brief Load verified program image from the cache.
+ *
+ * Image is mapped as is, its checksum and code are not checked again.
+ *
+ * @param cache_dir cache directory
+ * @param key hash of the original file (see get_image_key())
+ * @param stamp hash of the current processor build
+ * @param program where to put the program
+ * @return true if the image was found and loaded
+ */
+bool load_image(const char* cache_dir, hash_t key, hash_t stamp, Program* program);
+
+/**
+ * @brief Save verified program into the cache.
+ *
+ * Image is written to a temporary file and renamed, so concurrent runs never see partially written images.
+ *
+ * @param cache_dir cache directory (created if it does not exist)
+ * @param key hash of the original file (see get_image_key())
+ * @param stamp hash of the current processor build
+ * @param program verified program
+ */
+void save_image(const char* cache_dir, hash_t key, hash_t stamp, const Program* program);
+
+#endif
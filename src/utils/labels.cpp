@@ -0,0 +1,41 @@
+#include "labels.h"
+
+#include "lib/util/dbg/logger.h"
+
+void LabelSet_ctor(LabelSet* set) {
+    set->array = (CodeLabel*)calloc(set->max_size, sizeof(*set->array));
+    set->size = 0;
+}
+
+void LabelSet_dtor(LabelSet* set) {
+    if (set->array) free(set->array);
+    set->array = NULL;
+    set->size = 0;
+}
+
+void add_label(LabelSet* labels, hash_t hash, uintptr_t point, int* const err_code) {
+    _LOG_FAIL_CHECK_(labels->array, "error", ERROR_REPORTS, return, err_code, ENOENT);
+
+    for (size_t label_id = 0; label_id < labels->size; ++label_id) {
+        if (hash == labels->array[label_id].hash) {
+            labels->array[label_id].point = point;
+            return;
+        }
+    }
+
+    _LOG_FAIL_CHECK_(labels->size < labels->max_size, "error", ERROR_REPORTS, return, err_code, ENOMEM);
+
+    labels->array[labels->size].hash  = hash;
+    labels->array[labels->size].point = point;
+    ++labels->size;
+}
+
+uintptr_t get_label(const LabelSet* labels, hash_t hash, int* const err_code) {
+    _LOG_FAIL_CHECK_(labels->array, "error", ERROR_REPORTS, return 0, err_code, ENOENT);
+
+    for (size_t label_id = 0; label_id < labels->size; ++label_id) {
+        if (hash == labels->array[label_id].hash) return labels->array[label_id].point;
+    }
+
+    return 0;
+}
\ No newline at end of file
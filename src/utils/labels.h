@@ -0,0 +1,71 @@
+/**
+ * @file labels.h
+ * @author Kudryashov Ilya (kudriashov.it@phystech.edu)
+ * @brief Code label tables.
+ * @version 0.1
+ * @date 2022-11-02
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#ifndef LABELS_H
+#define LABELS_H
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "lib/util/dbg/debug.h"
+
+/**
+ * @brief JMP destination, marked in code with HERE word.
+ * 
+ * @param hash label name hash
+ * @param point label jump dastination
+ * @param name (unused) label name
+ */
+struct CodeLabel {
+    hash_t hash = 0;
+    uintptr_t point = 0;
+    const char* name = NULL;
+};
+
+/**
+ * @brief Set of code labels.
+ * 
+ * @param array list of labels
+ * @param max_size max number of labels the set can store
+ */
+struct LabelSet {
+    CodeLabel* array = NULL;
+    size_t size = 0;
+    size_t max_size = 1024;
+};
+
+void LabelSet_ctor(LabelSet* set);
+
+void LabelSet_dtor(LabelSet* set);
+
+/**
+ * @brief Add label to label table.
+ * 
+ * @param labels set of labels to add the label to
+ * @param hash label name hash
+ * @param point label value
+ * @param err_code variable to use as errno
+ */
+void add_label(LabelSet* labels, hash_t hash, uintptr_t point, int* const err_code = NULL);
+
+/**
+ * @brief Get the label value from label name hash.
+ * 
+ * Does not modify the set, so it is safe to call from multiple threads.
+ * 
+ * @param labels set of labels to get the label from
+ * @param hash label name hash
+ * @param err_code variable to use as errno
+ * @return uintptr_t label value or 0 if label was not declared
+ */
+uintptr_t get_label(const LabelSet* labels, hash_t hash, int* const err_code = NULL);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,169 @@
+#include "mem_kernels.h"
+
+#include <string.h>
+#include <limits.h>
+
+#include "lib/util/dbg/logger.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <immintrin.h>
+    #define MEM_KERNELS_X86
+#endif
+
+//* warning: stack protector not protecting function: all local arrays are less than 8 bytes long [-Wstack-protector]
+#pragma GCC diagnostic ignored "-Wstack-protector"
+
+/**
+ * @brief Implementations of bulk operations for one instruction set.
+ *
+ * @param fill mem_fill implementation
+ * @param sum mem_sum implementation
+ * @param max mem_max implementation
+ */
+struct MemKernels {
+    void (*fill)(int* dest, size_t count, int value);
+    long long (*sum)(const int* src, size_t count);
+    int (*max)(const int* src, size_t count);
+};
+
+/**
+ * @brief Pick kernels for the best instruction set supported by the CPU.
+ *
+ * @return MemKernels kernels to use
+ */
+static MemKernels select_kernels();
+
+/**
+ * @brief Get kernels selected on the first call.
+ *
+ * @return const MemKernels& kernels to use
+ */
+static const MemKernels& get_kernels();
+
+static void fill_scalar(int* dest, size_t count, int value) {
+    for (size_t id = 0; id < count; ++id) dest[id] = value;
+}
+
+static long long sum_scalar(const int* src, size_t count) {
+    long long answer = 0;
+    for (size_t id = 0; id < count; ++id) answer += src[id];
+    return answer;
+}
+
+static int max_scalar(const int* src, size_t count) {
+    int answer = INT_MIN;
+    for (size_t id = 0; id < count; ++id) if (src[id] > answer) answer = src[id];
+    return answer;
+}
+
+#ifdef MEM_KERNELS_X86
+
+//* Vector loops process whole vectors and leave the remaining cells to the scalar kernels.
+
+__attribute__((target("sse4.1")))
+static void fill_sse(int* dest, size_t count, int value) {
+    __m128i pattern = _mm_set1_epi32(value);
+    size_t id = 0;
+    for (; id + 4 <= count; id += 4) _mm_storeu_si128((__m128i*)(dest + id), pattern);
+    fill_scalar(dest + id, count - id, value);
+}
+
+__attribute__((target("sse4.1")))
+static long long sum_sse(const int* src, size_t count) {
+    __m128i total = _mm_setzero_si128();
+    size_t id = 0;
+    for (; id + 4 <= count; id += 4) {
+        __m128i block = _mm_loadu_si128((const __m128i*)(src + id));
+        total = _mm_add_epi64(total, _mm_cvtepi32_epi64(block));
+        total = _mm_add_epi64(total, _mm_cvtepi32_epi64(_mm_srli_si128(block, 8)));
+    }
+    long long lanes[2] = {};
+    _mm_storeu_si128((__m128i*)lanes, total);
+    return lanes[0] + lanes[1] + sum_scalar(src + id, count - id);
+}
+
+__attribute__((target("sse4.1")))
+static int max_sse(const int* src, size_t count) {
+    __m128i answer = _mm_set1_epi32(INT_MIN);
+    size_t id = 0;
+    for (; id + 4 <= count; id += 4) answer = _mm_max_epi32(answer, _mm_loadu_si128((const __m128i*)(src + id)));
+    int lanes[4] = {};
+    _mm_storeu_si128((__m128i*)lanes, answer);
+    int head = max_scalar(lanes, 4);
+    int tail = max_scalar(src + id, count - id);
+    return head > tail ? head : tail;
+}
+
+__attribute__((target("avx2")))
+static void fill_avx2(int* dest, size_t count, int value) {
+    __m256i pattern = _mm256_set1_epi32(value);
+    size_t id = 0;
+    for (; id + 8 <= count; id += 8) _mm256_storeu_si256((__m256i*)(dest + id), pattern);
+    fill_scalar(dest + id, count - id, value);
+}
+
+__attribute__((target("avx2")))
+static long long sum_avx2(const int* src, size_t count) {
+    __m256i total = _mm256_setzero_si256();
+    size_t id = 0;
+    for (; id + 8 <= count; id += 8) {
+        __m256i block = _mm256_loadu_si256((const __m256i*)(src + id));
+        total = _mm256_add_epi64(total, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(block)));
+        total = _mm256_add_epi64(total, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(block, 1)));
+    }
+    long long lanes[4] = {};
+    _mm256_storeu_si256((__m256i*)lanes, total);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + sum_scalar(src + id, count - id);
+}
+
+__attribute__((target("avx2")))
+static int max_avx2(const int* src, size_t count) {
+    __m256i answer = _mm256_set1_epi32(INT_MIN);
+    size_t id = 0;
+    for (; id + 8 <= count; id += 8) answer = _mm256_max_epi32(answer, _mm256_loadu_si256((const __m256i*)(src + id)));
+    int lanes[8] = {};
+    _mm256_storeu_si256((__m256i*)lanes, answer);
+    int head = max_scalar(lanes, 8);
+    int tail = max_scalar(src + id, count - id);
+    return head > tail ? head : tail;
+}
+
+#endif
+
+static MemKernels select_kernels() {
+#ifdef MEM_KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        log_printf(STATUS_REPORTS, "status", "Using AVX2 memory kernels.\n");
+        return (MemKernels) { fill_avx2, sum_avx2, max_avx2 };
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        log_printf(STATUS_REPORTS, "status", "Using SSE4.1 memory kernels.\n");
+        return (MemKernels) { fill_sse, sum_sse, max_sse };
+    }
+#endif
+    log_printf(STATUS_REPORTS, "status", "Using scalar memory kernels.\n");
+    return (MemKernels) { fill_scalar, sum_scalar, max_scalar };
+}
+
+static const MemKernels& get_kernels() {
+    static const MemKernels KERNELS = select_kernels();
+    return KERNELS;
+}
+
+void mem_fill(int* dest, size_t count, int value) {
+    get_kernels().fill(dest, count, value);
+}
+
+void mem_copy(int* dest, const int* src, size_t count) {
+    //* C library memmove already picks a vectorised copy for the CPU.
+    memmove(dest, src, count * sizeof(*dest));
+}
+
+long long mem_sum(const int* src, size_t count) {
+    return get_kernels().sum(src, count);
+}
+
+int mem_max(const int* src, size_t count) {
+    return get_kernels().max(src, count);
+}
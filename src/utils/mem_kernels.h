@@ -0,0 +1,53 @@
+/**
+ * @file mem_kernels.h
+ * @author Kudryashov Ilya (kudriashov.it@phystech.edu)
+ * @brief Bulk operations over RAM cells.
+ * @version 0.1
+ * @date 2022-11-13
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef MEM_KERNELS_H
+#define MEM_KERNELS_H
+
+#include <stdlib.h>
+
+/**
+ * @brief Put the value into consecutive cells.
+ *
+ * @param dest first cell
+ * @param count number of cells
+ * @param value value to put
+ */
+void mem_fill(int* dest, size_t count, int value);
+
+/**
+ * @brief Copy consecutive cells (ranges can overlap).
+ *
+ * @param dest first destination cell
+ * @param src first source cell
+ * @param count number of cells
+ */
+void mem_copy(int* dest, const int* src, size_t count);
+
+/**
+ * @brief Calculate sum of consecutive cells.
+ *
+ * @param src first cell
+ * @param count number of cells
+ * @return long long sum of the cells
+ */
+long long mem_sum(const int* src, size_t count);
+
+/**
+ * @brief Find maximum of consecutive cells.
+ *
+ * @param src first cell
+ * @param count number of cells
+ * @return int maximal value (INT_MIN if count is 0)
+ */
+int mem_max(const int* src, size_t count);
+
+#endif
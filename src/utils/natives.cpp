@@ -0,0 +1,170 @@
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+
+#include "lib/util/dbg/debug.h"
+#include "argworks.h"
+
+#define PROCESSOR
+
+#include "natives.h"
+#include "cmd_executor.h"
+
+//* warning: stack protector not protecting function: all local arrays are less than 8 bytes long [-Wstack-protector]
+#pragma GCC diagnostic ignored "-Wstack-protector"
+
+/**
+ * @brief Machine state available to native functions.
+ *
+ * @param stack stack to take arguments from and put results to
+ * @param ram virtual RAM
+ * @param reg virtual register
+ * @param err_code variable to use as errno
+ */
+struct NativeEnv {
+    Stack* stack;
+    MemorySegment* ram;
+    MemorySegment* reg;
+    int* err_code;
+};
+
+/**
+ * @brief Take the last element from the stack.
+ *
+ * @param env machine state
+ * @return stack_content_t removed element
+ */
+static stack_content_t pop_value(NativeEnv* env);
+
+/**
+ * @brief Take start and size of the RAM range from the stack and check its bounds.
+ *
+ * @param env machine state
+ * @param count where to put the number of cells
+ * @return int* first cell of the range (NULL if the range does not fit into RAM)
+ */
+static int* pop_range(NativeEnv* env, int* count);
+
+/**
+ * @brief Compare two RAM cells for qsort().
+ *
+ * @param first first cell
+ * @param second second cell
+ * @return int comparison result
+ */
+static int compare_cells(const void* first, const void* second);
+
+#define DEF_NATIVE(name, pops, pushes) static bool native_##name(NativeEnv* env);
+
+#include "src/natdef.h"
+
+#undef DEF_NATIVE
+
+#define DEF_NATIVE(name, pops, pushes) native_##name,
+
+//* Native function implementations indexed by function id.
+static bool (* const NATIVES[])(NativeEnv* env) = {
+    #include "src/natdef.h"
+};
+
+#undef DEF_NATIVE
+
+bool call_native(unsigned int native_id, Stack* stack, MemorySegment* ram, MemorySegment* reg, int* const err_code) {
+    _LOG_FAIL_CHECK_(stack && ram && reg, "error", ERROR_REPORTS, return false, err_code, EFAULT);
+
+    _LOG_FAIL_CHECK_(native_id < NATIVE_COUNT, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Unknown native function %u.\n", native_id);
+        return false;
+    }, err_code, EINVAL);
+
+    _LOG_FAIL_CHECK_(stack->size >= NATIVE_INFO[native_id].pops, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Native function %s takes %d values from the stack, but it has only %lu.\n",
+                                           NATIVE_INFO[native_id].name, NATIVE_INFO[native_id].pops, stack->size);
+        return false;
+    }, err_code, EFAULT);
+
+    NativeEnv env = { stack, ram, reg, err_code };
+    return NATIVES[native_id](&env);
+}
+
+static bool native_ABS(NativeEnv* env) {
+    stack_content_t value = pop_value(env);
+    stack_push(env->stack, value < 0 && value != LLONG_MIN ? -value : value, env->err_code);
+    return true;
+}
+
+static bool native_ISQRT(NativeEnv* env) {
+    stack_content_t value = pop_value(env);
+    _LOG_FAIL_CHECK_(value >= 0, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "ISQRT of a negative value %lld.\n", value);
+        return false;
+    }, env->err_code, EDOM);
+
+    //* Double rounding can be off by one for large values.
+    stack_content_t root = (stack_content_t)sqrt((double)value);
+    while (root > 0 && root > value / root) --root;
+    while (root + 1 <= value / (root + 1)) ++root;
+
+    stack_push(env->stack, root, env->err_code);
+    return true;
+}
+
+static bool native_FSIN(NativeEnv* env) {
+    stack_push(env->stack, pack_double(sin(unpack_double(pop_value(env)))), env->err_code);
+    return true;
+}
+
+static bool native_FCOS(NativeEnv* env) {
+    stack_push(env->stack, pack_double(cos(unpack_double(pop_value(env)))), env->err_code);
+    return true;
+}
+
+static bool native_FPOW(NativeEnv* env) {
+    double base = unpack_double(pop_value(env));
+    double exponent = unpack_double(pop_value(env));
+    stack_push(env->stack, pack_double(pow(base, exponent)), env->err_code);
+    return true;
+}
+
+static bool native_SORT(NativeEnv* env) {
+    int count = 0;
+    int* cells = pop_range(env, &count);
+    if (!cells) return false;
+
+    qsort(cells, (size_t)count, sizeof(*cells), compare_cells);
+    return true;
+}
+
+static bool native_HASH(NativeEnv* env) {
+    int count = 0;
+    int* cells = pop_range(env, &count);
+    if (!cells) return false;
+
+    stack_push(env->stack, (stack_content_t)get_hash(cells, cells + count), env->err_code);
+    return true;
+}
+
+static stack_content_t pop_value(NativeEnv* env) {
+    stack_content_t value = stack_get(env->stack, env->err_code);
+    stack_pop(env->stack, env->err_code);
+    return value;
+}
+
+static int* pop_range(NativeEnv* env, int* count) {
+    stack_content_t start = pop_value(env);
+    stack_content_t size = pop_value(env);
+
+    _LOG_FAIL_CHECK_(INT_MIN <= start && start <= INT_MAX && INT_MIN <= size && size <= INT_MAX, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "RAM range of %lld cells at %lld is too large.\n", size, start);
+        return NULL;
+    }, env->err_code, EFAULT);
+
+    *count = (int)size;
+    return link_ram_range(*env->ram, (int)start, (int)size, env->err_code);
+}
+
+static int compare_cells(const void* first, const void* second) {
+    int left = *(const int*)first, right = *(const int*)second;
+    return (left > right) - (left < right);
+}
@@ -0,0 +1,82 @@
+/**
+ * @file natives.h
+ * @author Kudryashov Ilya (kudriashov.it@phystech.edu)
+ * @brief Native functions available to programs through CALLN.
+ * @version 0.1
+ * @date 2022-11-14
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef NATIVES_H
+#define NATIVES_H
+
+#include <string.h>
+
+#define DEF_NATIVE(name, pops, pushes) NATIVE_##name,
+
+enum NATIVE_LIST {
+    #include "src/natdef.h"
+    NATIVE_COUNT,
+};
+
+#undef DEF_NATIVE
+
+/**
+ * @brief Description of the native function.
+ *
+ * @param name function as it should be written after CALLN
+ * @param pops number of values taken from the stack
+ * @param pushes number of values put onto the stack
+ */
+struct NativeInfo {
+    const char* name;
+    unsigned char pops;
+    unsigned char pushes;
+};
+
+#define DEF_NATIVE(name, pops, pushes) { #name, pops, pushes },
+
+//* Native function table indexed by function id.
+constexpr NativeInfo NATIVE_INFO[] = {
+    #include "src/natdef.h"
+};
+
+#undef DEF_NATIVE
+
+/**
+ * @brief Find native function by its name.
+ *
+ * @param name NUL-terminated function name
+ * @return int function id (-1 if there is no such function)
+ */
+static inline int find_native(const char* name) {
+    for (int native_id = 0; native_id < NATIVE_COUNT; ++native_id) {
+        if (strcmp(NATIVE_INFO[native_id].name, name) == 0) return native_id;
+    }
+    return -1;
+}
+
+#endif
+
+#if defined(PROCESSOR) && !defined(NATIVES_PROCESSOR_H)
+#define NATIVES_PROCESSOR_H
+
+#include "src/config.h"
+#include "lib/_stackworks.h"
+#include "common.h"
+
+/**
+ * @brief Call the native function.
+ *
+ * @param native_id function id
+ * @param stack stack to take arguments from and put results to
+ * @param ram virtual RAM
+ * @param reg virtual register
+ * @param err_code variable to use as errno
+ * @return true if the function succeeded
+ */
+bool call_native(unsigned int native_id, Stack* stack, MemorySegment* ram, MemorySegment* reg, int* const err_code = NULL);
+
+#endif
@@ -0,0 +1,118 @@
+#include "objfile.h"
+
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "lib/util/dbg/logger.h"
+#include "lib/file_proc.h"
+
+//* warning: stack protector not protecting function: all local arrays are less than 8 bytes long [-Wstack-protector]
+#pragma GCC diagnostic ignored "-Wstack-protector"
+
+//* Symbol table is aligned so it can be used in place.
+static const size_t OBJ_TABLE_ALIGNMENT = 8;
+
+/**
+ * @brief Get the offset of the symbol table from the start of the file.
+ *
+ * @param section_size size of module code and data
+ * @return size_t
+ */
+static size_t symbol_table_offset(size_t section_size);
+
+void ObjectFile_dtor(ObjectFile* object) {
+    if (object->content) free(object->content);
+    *object = {};
+}
+
+void write_object(FILE* output, const ObjectFile* object, int* const err_code) {
+    _LOG_FAIL_CHECK_(output, "error", ERROR_REPORTS, return, err_code, EFAULT);
+    _LOG_FAIL_CHECK_(object, "error", ERROR_REPORTS, return, err_code, EFAULT);
+
+    ObjHeader header = {};
+    memcpy(header.prefix, OBJ_PREFIX, sizeof(header.prefix));
+    header.code_size        = (uint32_t)object->code_size;
+    header.data_size        = (uint32_t)object->data_size;
+    header.symbol_count     = (uint32_t)object->symbol_count;
+    header.relocation_count = (uint32_t)object->relocation_count;
+
+    fwrite(&header, sizeof(header), 1, output);
+    if (object->code_size) fwrite(object->code, sizeof(char), object->code_size, output);
+    if (object->data_size) fwrite(object->data, sizeof(char), object->data_size, output);
+
+    size_t section_size = object->code_size + object->data_size;
+
+    static const char padding[OBJ_TABLE_ALIGNMENT] = {};
+    fwrite(padding, sizeof(char), symbol_table_offset(section_size) - sizeof(header) - section_size, output);
+
+    if (object->symbol_count) fwrite(object->symbols, sizeof(*object->symbols), object->symbol_count, output);
+    if (object->relocation_count) fwrite(object->relocations, sizeof(*object->relocations), object->relocation_count, output);
+}
+
+void read_object(const char* file_name, ObjectFile* object, int* const err_code) {
+    _LOG_FAIL_CHECK_(file_name, "error", ERROR_REPORTS, return, err_code, EFAULT);
+    _LOG_FAIL_CHECK_(object, "error", ERROR_REPORTS, return, err_code, EFAULT);
+
+    int fd = open(file_name, O_RDONLY);
+    _LOG_FAIL_CHECK_(fd != -1, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Failed to open object file %s.\n", file_name);
+        return;
+    }, err_code, ENOENT);
+
+    object->size = flength(fd);
+    object->content = (char*) calloc(object->size + 1, sizeof(*object->content));
+    _LOG_FAIL_CHECK_(object->content, "error", ERROR_REPORTS, {
+        close(fd);
+        return;
+    }, err_code, ENOMEM);
+
+    ssize_t read_size = read(fd, object->content, object->size);
+    close(fd);
+
+    ObjHeader header = {};
+    if (read_size >= 0 && (size_t)read_size == object->size && object->size >= sizeof(header)) {
+        memcpy(&header, object->content, sizeof(header));
+    }
+
+    _LOG_FAIL_CHECK_(strncmp(header.prefix, OBJ_PREFIX, sizeof(header.prefix)) == 0 && header.version == OBJ_VERSION,
+                     "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "File %s is not a version %d object file.\n", file_name, OBJ_VERSION);
+        ObjectFile_dtor(object);
+        return;
+    }, err_code, EIO);
+
+    size_t symbol_offset = symbol_table_offset((size_t)header.code_size + header.data_size);
+    size_t relocation_offset = symbol_offset + header.symbol_count * sizeof(ObjSymbol);
+
+    _LOG_FAIL_CHECK_(relocation_offset + header.relocation_count * sizeof(ObjRelocation) <= object->size,
+                     "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Object file %s is truncated.\n", file_name);
+        ObjectFile_dtor(object);
+        return;
+    }, err_code, EIO);
+
+    object->code = object->content + sizeof(header);
+    object->code_size = header.code_size;
+    object->data = object->code + header.code_size;
+    object->data_size = header.data_size;
+    object->symbols = (const ObjSymbol*)(object->content + symbol_offset);
+    object->symbol_count = header.symbol_count;
+    object->relocations = (const ObjRelocation*)(object->content + relocation_offset);
+    object->relocation_count = header.relocation_count;
+
+    for (size_t reloc_id = 0; reloc_id < object->relocation_count; ++reloc_id) {
+        _LOG_FAIL_CHECK_(object->relocations[reloc_id].operand + sizeof(int) <= object->code_size &&
+                         object->relocations[reloc_id].instruction < object->code_size, "error", ERROR_REPORTS, {
+            log_printf(ERROR_REPORTS, "error", "Relocation %lu of object file %s points outside of the code.\n",
+                                               reloc_id, file_name);
+            ObjectFile_dtor(object);
+            return;
+        }, err_code, EIO);
+    }
+}
+
+static size_t symbol_table_offset(size_t section_size) {
+    size_t offset = sizeof(ObjHeader) + section_size;
+    return (offset + OBJ_TABLE_ALIGNMENT - 1) / OBJ_TABLE_ALIGNMENT * OBJ_TABLE_ALIGNMENT;
+}
@@ -0,0 +1,119 @@
+/**
+ * @file objfile.h
+ * @author Kudryashov Ilya (kudriashov.it@phystech.edu)
+ * @brief Relocatable object files produced by the assembler and merged by the linker.
+ * @version 0.1
+ * @date 2022-11-05
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef OBJFILE_H
+#define OBJFILE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "lib/util/dbg/debug.h"
+#include "src/procinfo.h"
+
+static const char OBJ_PREFIX[] = "KITo";
+const version_t OBJ_VERSION = 3;
+
+/**
+ * @brief Object file header.
+ *
+ * Header is followed by the code, data blocks, symbol table aligned to 8 bytes and relocation table.
+ *
+ * @param prefix object file prefix (OBJ_PREFIX)
+ * @param version object file format version
+ * @param code_size number of code bytes
+ * @param data_size number of data section bytes
+ * @param symbol_count number of exported symbols
+ * @param relocation_count number of relocation records
+ */
+struct ObjHeader {
+    char prefix[4] = {};
+    version_t version = OBJ_VERSION;
+    uint32_t code_size = 0;
+    uint32_t data_size = 0;
+    uint32_t symbol_count = 0;
+    uint32_t relocation_count = 0;
+};
+
+/**
+ * @brief Label exported from the module with GLOBAL directive.
+ *
+ * @param hash label name hash
+ * @param point label offset from the start of module code
+ */
+struct ObjSymbol {
+    hash_t hash = 0;
+    uint32_t point = 0;
+};
+
+/**
+ * @brief Jump operand referring to a label declared in another module.
+ *
+ * Operand is filled by the linker with the distance from the instruction to the label.
+ *
+ * @param symbol label name hash
+ * @param instruction offset of the instruction from the start of module code
+ * @param operand offset of the operand from the start of module code
+ */
+struct ObjRelocation {
+    hash_t symbol = 0;
+    uint32_t instruction = 0;
+    uint32_t operand = 0;
+};
+
+/**
+ * @brief Object file loaded into memory.
+ *
+ * @param content file content
+ * @param size file size
+ * @param code module code
+ * @param code_size number of code bytes
+ * @param data data blocks (see DataBlock)
+ * @param data_size number of data bytes
+ * @param symbols exported symbols
+ * @param symbol_count number of exported symbols
+ * @param relocations relocation records
+ * @param relocation_count number of relocation records
+ */
+struct ObjectFile {
+    char* content = NULL;
+    size_t size = 0;
+    const char* code = NULL;
+    size_t code_size = 0;
+    const char* data = NULL;
+    size_t data_size = 0;
+    const ObjSymbol* symbols = NULL;
+    size_t symbol_count = 0;
+    const ObjRelocation* relocations = NULL;
+    size_t relocation_count = 0;
+};
+
+void ObjectFile_dtor(ObjectFile* object);
+
+/**
+ * @brief Write object file.
+ *
+ * @param output file to write to
+ * @param object module to write (content and size are ignored)
+ * @param err_code variable to use as errno
+ */
+void write_object(FILE* output, const ObjectFile* object, int* const err_code = NULL);
+
+/**
+ * @brief Read and validate object file.
+ *
+ * @param file_name name of the object file
+ * @param object where to put the module
+ * @param err_code variable to use as errno
+ */
+void read_object(const char* file_name, ObjectFile* object, int* const err_code = NULL);
+
+#endif
@@ -0,0 +1,166 @@
+#include "packed_code.h"
+
+#include <string.h>
+#include <stdint.h>
+
+#include "lib/util/dbg/debug.h"
+#include "src/proccmd.h"
+#include "argworks.h"
+
+//* warning: stack protector not protecting function: all local arrays are less than 8 bytes long [-Wstack-protector]
+#pragma GCC diagnostic ignored "-Wstack-protector"
+
+//* 32-bit value takes at most 5 varint bytes of 7 bits.
+static const size_t MAX_VARINT_LENGTH = 5;
+
+//* Commands with up to this many 4-byte arguments have them stored as varints.
+static const size_t MAX_PACKED_INTS = 3;
+
+/**
+ * @brief Get number of 4-byte arguments of the command stored as varints.
+ *
+ * @param info command description
+ * @return size_t number of varints (0 if the argument is stored as is)
+ */
+static inline size_t packed_int_count(const CmdInfo* info) {
+    size_t count = info->arg_size / sizeof(int);
+    return info->arg_size % sizeof(int) == 0 && count <= MAX_PACKED_INTS ? count : 0;
+}
+
+/**
+ * @brief Check if the command stores register id in its header.
+ *
+ * @param opcode opcode byte
+ * @return true if register id is stored
+ */
+static inline bool uses_register(unsigned char opcode) {
+    return (CMD_INFO[opcode >> 2].flags & CMD_F_MASKED) && (opcode & USE_REGISTER);
+}
+
+void pack_code(const char* code, size_t size, PseudoFile* packed, int* const err_code) {
+    _LOG_FAIL_CHECK_(code && packed, "error", ERROR_REPORTS, return, err_code, EFAULT);
+
+    for (size_t offset = 0; offset < size;) {
+        unsigned char opcode = (unsigned char)code[offset];
+        size_t length = (size_t)cmd_length(opcode >> 2);
+
+        _LOG_FAIL_CHECK_(length && offset + length <= size, "error", ERROR_REPORTS, {
+            log_printf(ERROR_REPORTS, "error", "Invalid command [%0X] at code offset 0x%lX can not be packed.\n",
+                                               opcode >> 2, offset);
+            return;
+        }, err_code, EINVAL);
+
+        const CmdInfo* info = &CMD_INFO[opcode >> 2];
+
+        unsigned char sequence[2 + MAX_PACKED_INTS * MAX_VARINT_LENGTH] = { opcode };
+        size_t sequence_length = 1;
+
+        if (uses_register(opcode)) sequence[sequence_length++] = (unsigned char)code[offset + 1];
+
+        size_t int_count = packed_int_count(info);
+        for (size_t int_id = 0; int_id < int_count; ++int_id) {
+            int argument = 0;
+            memcpy(&argument, code + offset + CMD_HEADER_SIZE + int_id * sizeof(int), sizeof(argument));
+
+            //* Jumps to labels land on command starts, which are aligned to the command header.
+            if ((info->flags & CMD_F_BRANCH) && int_id + 1 == int_count) {
+                _LOG_FAIL_CHECK_(argument % CMD_HEADER_SIZE == 0, "error", ERROR_REPORTS, {
+                    log_printf(ERROR_REPORTS, "error", "Branch distance %d of %s at code offset 0x%lX is not a multiple "
+                                                       "of %d and can not be packed.\n",
+                                                       argument, info->name, offset, CMD_HEADER_SIZE);
+                    return;
+                }, err_code, EINVAL);
+                argument /= CMD_HEADER_SIZE;
+            }
+
+            uint32_t value = ((uint32_t)argument << 1) ^ (uint32_t)(argument >> 31);
+            do {
+                sequence[sequence_length++] = (unsigned char)((value & 0x7F) | (value > 0x7F ? 0x80 : 0));
+                value >>= 7;
+            } while (value);
+        }
+
+        PseudoFile_append(packed, sequence, sequence_length, err_code);
+        if (int_count == 0) {
+            PseudoFile_append(packed, code + offset + CMD_HEADER_SIZE, info->arg_size, err_code);
+        }
+
+        offset += length;
+    }
+}
+
+size_t unpack_code(const char* packed, size_t packed_size, char* code, int* const err_code) {
+    _LOG_FAIL_CHECK_(packed, "error", ERROR_REPORTS, return 0, err_code, EFAULT);
+
+    size_t size = 0;
+
+    for (size_t offset = 0; offset < packed_size;) {
+        unsigned char opcode = (unsigned char)packed[offset++];
+        size_t length = (size_t)cmd_length(opcode >> 2);
+
+        _LOG_FAIL_CHECK_(length, "error", ERROR_REPORTS, {
+            log_printf(ERROR_REPORTS, "error", "Unknown packed command [%0X] at 0x%lX.\n", opcode >> 2, offset - 1);
+            return 0;
+        }, err_code, EIO);
+
+        const CmdInfo* info = &CMD_INFO[opcode >> 2];
+
+        unsigned char reg_id = 0;
+        if (uses_register(opcode)) {
+            _LOG_FAIL_CHECK_(offset < packed_size, "error", ERROR_REPORTS, {
+                log_printf(ERROR_REPORTS, "error", "Packed command %s is cut.\n", info->name);
+                return 0;
+            }, err_code, EIO);
+
+            reg_id = (unsigned char)packed[offset++];
+        }
+
+        if (code) {
+            memset(code + size, 0, length);
+            code[size] = (char)opcode;
+            code[size + 1] = (char)reg_id;
+        }
+
+        size_t int_count = packed_int_count(info);
+        for (size_t int_id = 0; int_id < int_count; ++int_id) {
+            uint32_t value = 0;
+            size_t shift = 0;
+            bool complete = false;
+
+            while (offset < packed_size && shift < 7 * MAX_VARINT_LENGTH) {
+                unsigned char byte = (unsigned char)packed[offset++];
+                value |= (uint32_t)(byte & 0x7F) << shift;
+                shift += 7;
+
+                if (!(byte & 0x80)) {
+                    complete = true;
+                    break;
+                }
+            }
+
+            _LOG_FAIL_CHECK_(complete, "error", ERROR_REPORTS, {
+                log_printf(ERROR_REPORTS, "error", "Argument of packed command %s is damaged.\n", info->name);
+                return 0;
+            }, err_code, EIO);
+
+            int argument = (int)(value >> 1) ^ -(int)(value & 1);
+            if ((info->flags & CMD_F_BRANCH) && int_id + 1 == int_count) argument *= CMD_HEADER_SIZE;
+
+            if (code) memcpy(code + size + CMD_HEADER_SIZE + int_id * sizeof(int), &argument, sizeof(argument));
+        }
+
+        if (int_count == 0) {
+            _LOG_FAIL_CHECK_(info->arg_size <= packed_size - offset, "error", ERROR_REPORTS, {
+                log_printf(ERROR_REPORTS, "error", "Argument of packed command %s is cut.\n", info->name);
+                return 0;
+            }, err_code, EIO);
+
+            if (code) memcpy(code + size + CMD_HEADER_SIZE, packed + offset, info->arg_size);
+            offset += info->arg_size;
+        }
+
+        size += length;
+    }
+
+    return size;
+}
@@ -0,0 +1,44 @@
+/**
+ * @file packed_code.h
+ * @author Kudryashov Ilya (kudriashov.it@phystech.edu)
+ * @brief Dense code encoding with variable-length arguments.
+ * @version 0.1
+ * @date 2022-11-10
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#ifndef PACKED_CODE_H
+#define PACKED_CODE_H
+
+#include <stdlib.h>
+
+#include "common.h"
+
+/**
+ * @brief Pack commands into the dense form.
+ * 
+ * Every command is stored as its opcode byte, register id (only if the command uses a register)
+ * and zigzag varints of its 4-byte arguments. Jump distances are stored in units of CMD_HEADER_SIZE,
+ * so short jumps take a single byte.
+ * 
+ * @param code commands in the regular aligned form
+ * @param size size of the code
+ * @param packed file to append packed commands to
+ * @param err_code variable to use as errno
+ */
+void pack_code(const char* code, size_t size, PseudoFile* packed, int* const err_code = NULL);
+
+/**
+ * @brief Expand packed commands back into the regular aligned form.
+ * 
+ * @param packed packed commands
+ * @param packed_size size of the packed code
+ * @param code buffer for the expanded code (NULL - only calculate its size)
+ * @param err_code variable to use as errno
+ * @return size_t size of the expanded code (0 if the packed code is invalid)
+ */
+size_t unpack_code(const char* packed, size_t packed_size, char* code, int* const err_code = NULL);
+
+#endif
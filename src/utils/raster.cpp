@@ -0,0 +1,59 @@
+#include "raster.h"
+
+#include "mem_kernels.h"
+
+//* warning: stack protector not protecting function: all local arrays are less than 8 bytes long [-Wstack-protector]
+#pragma GCC diagnostic ignored "-Wstack-protector"
+
+/**
+ * @brief Visible part of the rectangle.
+ *
+ * @param left first visible column
+ * @param top first visible row
+ * @param right column after the last visible one
+ * @param bottom row after the last visible one
+ */
+struct ClipRect {
+    long long left = 0, top = 0;
+    long long right = 0, bottom = 0;
+};
+
+/**
+ * @brief Clip the rectangle against the screen borders.
+ *
+ * @param vmd video memory
+ * @param x column of the left border
+ * @param y row of the top border
+ * @param width width of the rectangle
+ * @param height height of the rectangle
+ * @return ClipRect visible part (empty if left >= right or top >= bottom)
+ */
+static ClipRect clip_rect(const FrameBuffer* vmd, int x, int y, int width, int height) {
+    ClipRect rect = {};
+    rect.left   = x < 0 ? 0 : x;
+    rect.top    = y < 0 ? 0 : y;
+    rect.right  = (long long)x + width;
+    rect.bottom = (long long)y + height;
+    if (rect.right  > (long long)vmd->width)  rect.right  = (long long)vmd->width;
+    if (rect.bottom > (long long)vmd->height) rect.bottom = (long long)vmd->height;
+    return rect;
+}
+
+void vmd_fill_rect(FrameBuffer* vmd, int x, int y, int width, int height, int value) {
+    ClipRect rect = clip_rect(vmd, x, y, width, height);
+    if (rect.left >= rect.right) return;
+
+    for (long long row = rect.top; row < rect.bottom; ++row) {
+        mem_fill(vmd->content + row * (long long)vmd->width + rect.left, (size_t)(rect.right - rect.left), value);
+    }
+}
+
+void vmd_blit(FrameBuffer* vmd, int x, int y, int width, int height, const int* source) {
+    ClipRect rect = clip_rect(vmd, x, y, width, height);
+    if (rect.left >= rect.right) return;
+
+    for (long long row = rect.top; row < rect.bottom; ++row) {
+        mem_copy(vmd->content + row * (long long)vmd->width + rect.left,
+                 source + (row - y) * width + (rect.left - x), (size_t)(rect.right - rect.left));
+    }
+}
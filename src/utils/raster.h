@@ -0,0 +1,41 @@
+/**
+ * @file raster.h
+ * @author Kudryashov Ilya (kudriashov.it@phystech.edu)
+ * @brief Rectangle operations over the video memory.
+ * @version 0.1
+ * @date 2022-11-13
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef RASTER_H
+#define RASTER_H
+
+#include "common.h"
+
+/**
+ * @brief Put the value into every pixel of the rectangle (parts outside the screen are skipped).
+ *
+ * @param vmd video memory
+ * @param x column of the left border
+ * @param y row of the top border
+ * @param width width of the rectangle
+ * @param height height of the rectangle
+ * @param value value to put
+ */
+void vmd_fill_rect(FrameBuffer* vmd, int x, int y, int width, int height, int value);
+
+/**
+ * @brief Copy rectangle of values to the screen (parts outside the screen are skipped).
+ *
+ * @param vmd video memory
+ * @param x column of the left border
+ * @param y row of the top border
+ * @param width width of the rectangle
+ * @param height height of the rectangle
+ * @param source width * height values stored row by row
+ */
+void vmd_blit(FrameBuffer* vmd, int x, int y, int width, int height, const int* source);
+
+#endif
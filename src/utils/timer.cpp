@@ -0,0 +1,26 @@
+#include "timer.h"
+
+#include <time.h>
+#include <errno.h>
+
+//* warning: stack protector not protecting function: all local arrays are less than 8 bytes long [-Wstack-protector]
+#pragma GCC diagnostic ignored "-Wstack-protector"
+
+static const long long NANOSECONDS_PER_SECOND = 1000000000ll;
+
+long long timer_now() {
+    timespec moment = {};
+    clock_gettime(CLOCK_MONOTONIC, &moment);
+    return (long long)moment.tv_sec * NANOSECONDS_PER_SECOND + moment.tv_nsec;
+}
+
+void timer_sleep_until(long long moment) {
+    if (moment <= timer_now()) return;
+
+    timespec target = {};
+    target.tv_sec = (time_t)(moment / NANOSECONDS_PER_SECOND);
+    target.tv_nsec = (long)(moment % NANOSECONDS_PER_SECOND);
+
+    //* Sleep is restarted if a signal interrupts it, absolute time keeps the target unchanged.
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &target, NULL) == EINTR) {}
+}
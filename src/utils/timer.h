@@ -0,0 +1,29 @@
+/**
+ * @file timer.h
+ * @author Kudryashov Ilya (kudriashov.it@phystech.edu)
+ * @brief Monotonic clock of the processor.
+ * @version 0.1
+ * @date 2022-11-16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef TIMER_H
+#define TIMER_H
+
+/**
+ * @brief Get current time of the monotonic clock.
+ *
+ * @return long long nanoseconds since an unspecified starting point
+ */
+long long timer_now();
+
+/**
+ * @brief Suspend the processor until the monotonic clock reaches the time (returns immediately if it has passed).
+ *
+ * @param moment time as returned by timer_now()
+ */
+void timer_sleep_until(long long moment);
+
+#endif
@@ -0,0 +1,141 @@
+#include "verifier.h"
+
+#include <string.h>
+#include <stdint.h>
+
+#include "lib/util/dbg/debug.h"
+#include "src/proccmd.h"
+#include "argworks.h"
+#include "natives.h"
+
+//* Marks of code offsets.
+enum CODE_MARK {
+    MARK_COMMAND = 1 << 0,  //* A command starts at the offset.
+    MARK_TARGET  = 1 << 1,  //* A jump lands on the offset.
+};
+
+/**
+ * @brief Get number of values the command takes from the stack and puts onto it.
+ *
+ * @param command pointer to the command
+ * @param pops where to put the number of values taken from the stack
+ * @param pushes where to put the number of values put onto the stack
+ */
+static void stack_effect(const char* command, int* pops, int* pushes);
+
+/**
+ * @brief Check that commands executed right after the start never take more values than the stack has.
+ *
+ * The stack is empty at the start, the check stops at the first jump target, call or terminator,
+ * as the stack depth after them depends on the path taken.
+ *
+ * @param content file content
+ * @param marks CODE_MARK combination for every offset of the content
+ * @param code_begin offset of the first command
+ * @param code_end offset of the end of the code
+ * @return true if the stack can not underflow there
+ */
+static bool check_stack_depth(const char* content, const unsigned char* marks, size_t code_begin, size_t code_end);
+
+bool verify_code(const char* content, size_t code_begin, size_t code_end, int* const err_code) {
+    _LOG_FAIL_CHECK_(content, "error", ERROR_REPORTS, return false, err_code, EFAULT);
+
+    unsigned char* marks = (unsigned char*) calloc(code_end + 1, sizeof(*marks));
+    _LOG_FAIL_CHECK_(marks, "error", ERROR_REPORTS, return false, err_code, ENOMEM);
+
+    bool valid = true;
+
+    for (size_t offset = code_begin; valid && offset < code_end;) {
+        unsigned int cmd_id = (unsigned char)content[offset] >> 2;
+        unsigned int usage = (unsigned char)content[offset] & 3;
+        int length = cmd_length(cmd_id);
+
+        if (length == 0) {
+            log_printf(ERROR_REPORTS, "error", "Unknown command [%0X] at 0x%0*lX.\n",
+                                               cmd_id, (int)sizeof(uintptr_t), offset);
+            valid = false;
+        } else if (usage && !(CMD_INFO[cmd_id].flags & CMD_F_MASKED)) {
+            log_printf(ERROR_REPORTS, "error", "Command %s at 0x%0*lX can not use registers or RAM.\n",
+                                               CMD_INFO[cmd_id].name, (int)sizeof(uintptr_t), offset);
+            valid = false;
+        } else if (offset + (size_t)length > code_end) {
+            log_printf(ERROR_REPORTS, "error", "Argument of %s at 0x%0*lX is cut by the end of the code.\n",
+                                               CMD_INFO[cmd_id].name, (int)sizeof(uintptr_t), offset);
+            valid = false;
+        } else if (content[offset + 2] || content[offset + 3] || (content[offset + 1] && !(usage & USE_REGISTER))) {
+            log_printf(ERROR_REPORTS, "error", "Command %s at 0x%0*lX has unused header bytes set.\n",
+                                               CMD_INFO[cmd_id].name, (int)sizeof(uintptr_t), offset);
+            valid = false;
+        }
+
+        marks[offset] |= MARK_COMMAND;
+        offset += (size_t)length;
+    }
+
+    for (size_t offset = code_begin; valid && offset < code_end; offset += (size_t)cmd_length((unsigned char)content[offset] >> 2)) {
+        unsigned int cmd_id = (unsigned char)content[offset] >> 2;
+        if (!(CMD_INFO[cmd_id].flags & CMD_F_BRANCH)) continue;
+
+        int distance = 0;
+        memcpy(&distance, content + offset + cmd_length(cmd_id) - sizeof(distance), sizeof(distance));
+
+        long long target = (long long)offset + distance;
+        if (target >= (long long)code_begin && target < (long long)code_end && (marks[target] & MARK_COMMAND)) {
+            marks[target] |= MARK_TARGET;
+            continue;
+        }
+
+        log_printf(ERROR_REPORTS, "error", "Command %s at 0x%0*lX jumps to 0x%llX, which is not a start of a command.\n",
+                                           CMD_INFO[cmd_id].name, (int)sizeof(uintptr_t), offset, target);
+        valid = false;
+    }
+
+    if (valid) valid = check_stack_depth(content, marks, code_begin, code_end);
+
+    free(marks);
+
+    _LOG_FAIL_CHECK_(valid, "error", ERROR_REPORTS, return false, err_code, EINVAL);
+
+    return true;
+}
+
+static void stack_effect(const char* command, int* pops, int* pushes) {
+    unsigned int cmd_id = (unsigned char)command[0] >> 2;
+    const CmdAlias* alias = cmd_alias(command);
+
+    *pops = alias ? alias->pops : CMD_INFO[cmd_id].pops;
+    *pushes = alias ? alias->pushes : CMD_INFO[cmd_id].pushes;
+
+    if (cmd_id == CMD_CALLN) {
+        unsigned int native_id = 0;
+        memcpy(&native_id, command + CMD_HEADER_SIZE, sizeof(native_id));
+        if (native_id < NATIVE_COUNT) {
+            *pops = NATIVE_INFO[native_id].pops;
+            *pushes = NATIVE_INFO[native_id].pushes;
+        }
+    }
+}
+
+static bool check_stack_depth(const char* content, const unsigned char* marks, size_t code_begin, size_t code_end) {
+    int depth = 0;
+
+    for (size_t offset = code_begin; offset < code_end && !(marks[offset] & MARK_TARGET);
+         offset += (size_t)cmd_length((unsigned char)content[offset] >> 2)) {
+        unsigned int cmd_id = (unsigned char)content[offset] >> 2;
+
+        int pops = 0, pushes = 0;
+        stack_effect(content + offset, &pops, &pushes);
+
+        if (pops > depth) {
+            log_printf(ERROR_REPORTS, "error", "Command %s at 0x%0*lX takes %d values from the stack, which has only %d.\n",
+                                               cmd_name(content + offset), (int)sizeof(uintptr_t), offset, pops, depth);
+            return false;
+        }
+
+        depth += pushes - pops;
+
+        if (CMD_INFO[cmd_id].flags & (CMD_F_CALL | CMD_F_TERMINATOR)) break;
+    }
+
+    return true;
+}
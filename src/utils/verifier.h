@@ -0,0 +1,33 @@
+/**
+ * @file verifier.h
+ * @author Kudryashov Ilya (kudriashov.it@phystech.edu)
+ * @brief Load-time check of the program code against the command metadata table.
+ * @version 0.1
+ * @date 2022-11-08
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#ifndef VERIFIER_H
+#define VERIFIER_H
+
+#include <stdlib.h>
+
+/**
+ * @brief Check that the code is a valid sequence of commands.
+ * 
+ * Every opcode should be known and have usage bits and register id only if the command allows them,
+ * every argument should fit into the code and every jump should land on the start of a command.
+ * Commands executed right after the start (up to the first jump target, call or terminator)
+ * should not take more values than the stack has at that point.
+ * 
+ * @param content file content (offsets are counted from its start)
+ * @param code_begin offset of the first command
+ * @param code_end offset of the end of the code
+ * @param err_code variable to use as errno
+ * @return true if the code is valid
+ */
+bool verify_code(const char* content, size_t code_begin, size_t code_end, int* const err_code = NULL);
+
+#endif
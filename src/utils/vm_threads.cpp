@@ -0,0 +1,622 @@
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "lib/util/dbg/debug.h"
+#include "argworks.h"
+
+#define PROCESSOR
+
+#include "vm_threads.h"
+#include "cmd_executor.h"
+#include "frames.h"
+
+//* warning: stack protector not protecting function: all local arrays are less than 8 bytes long [-Wstack-protector]
+#pragma GCC diagnostic ignored "-Wstack-protector"
+
+/**
+ * @brief Private state of a command sequence being executed, RAM and VMD are shared.
+ *
+ * @param pointer current command
+ * @param stack operand stack
+ * @param addr_stack address stack
+ * @param frames local variable frames
+ * @param reg registers
+ * @param ram shared RAM
+ * @param vmd shared video memory
+ * @param err_code errno of the sequence
+ */
+struct VMState {
+    const char* pointer = NULL;
+    Stack stack = {};
+    Stack addr_stack = {};
+    FrameStack frames = {};
+    MemorySegment reg = {};
+    MemorySegment* ram = NULL;
+    FrameBuffer* vmd = NULL;
+    int err_code = 0;
+};
+
+/**
+ * @brief Thread started by SPAWN.
+ *
+ * @param handle system thread
+ * @param state execution state
+ */
+struct VMThread {
+    pthread_t handle = {};
+    VMState state = {};
+};
+
+/**
+ * @brief Loop executed by PFOR.
+ *
+ * @param loop PFOR command (bodies return to it)
+ * @param body first command of the body
+ * @param counter register receiving the index
+ * @param registers registers every iteration starts with
+ * @param ram shared RAM
+ * @param vmd shared video memory
+ * @param failed one of the iterations failed
+ * @param err_code errno of the first failed iteration
+ */
+struct PforJob {
+    const char* loop = NULL;
+    const char* body = NULL;
+    unsigned char counter = 0;
+    const MemorySegment* registers = NULL;
+    MemorySegment* ram = NULL;
+    FrameBuffer* vmd = NULL;
+    bool failed = false;
+    int err_code = 0;
+};
+
+/**
+ * @brief Participant of PFOR loops, the first one is the thread executing PFOR.
+ *
+ * @param handle system thread (unused for the first participant)
+ * @param state execution state of iterations
+ * @param lock protects the index range
+ * @param next first index of the range that was not taken
+ * @param end end of the range
+ */
+struct PforWorker {
+    pthread_t handle = {};
+    VMState state = {};
+    pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+    long long next = 0;
+    long long end = 0;
+};
+
+//* Threads that were not joined (NULL - free slot).
+static VMThread* THREADS[MAX_THREAD_COUNT] = {};
+static pthread_mutex_t THREADS_MUTEX = PTHREAD_MUTEX_INITIALIZER;
+
+static const char* program_content = NULL;
+static size_t program_code_end = 0;
+static bool stop_requested = false;
+
+static pthread_mutex_t BARRIER_MUTEX = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t BARRIER_COND = PTHREAD_COND_INITIALIZER;
+static long long barrier_arrived = 0;
+static unsigned long long barrier_generation = 0;
+
+//* Worker pool is started by the first PFOR and is used by one PFOR at a time (held while the loop runs).
+static pthread_mutex_t PFOR_BUSY = PTHREAD_MUTEX_INITIALIZER;
+//* Protects the fields below, workers wait for a new generation of the job.
+static pthread_mutex_t POOL_MUTEX = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t POOL_START = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t POOL_DONE = PTHREAD_COND_INITIALIZER;
+static PforWorker* pool = NULL;
+static size_t pool_size = 0;
+static unsigned long long pool_generation = 0;
+static size_t pool_pending = 0;
+static bool pool_shutdown = false;
+static PforJob pool_job = {};
+
+//* Every chunk takes this part of the indices left in the range of the participant.
+static const long long PFOR_CHUNK_DIVISOR = 4;
+
+/**
+ * @brief Allocate stacks, frames and a copy of the registers.
+ *
+ * @param state state to initialize
+ * @param registers registers to copy
+ * @return true if everything was allocated
+ */
+static bool VMState_ctor(VMState* state, const MemorySegment* registers);
+
+/**
+ * @brief Free stacks, frames and registers.
+ *
+ * @param state state to free
+ */
+static void VMState_dtor(VMState* state);
+
+/**
+ * @brief Execute commands until END, an error or the stop point.
+ *
+ * @param state state to execute
+ * @param stop_point command to stop at (NULL - only stop at END or an error)
+ */
+static void run_state(VMState* state, const char* stop_point);
+
+/**
+ * @brief Execute commands of the thread (thread routine).
+ *
+ * @param thread_ptr VMThread to run
+ * @return void* NULL
+ */
+static void* run_thread(void* thread_ptr);
+
+/**
+ * @brief Execute PFOR body for one index.
+ *
+ * @param state state of the participant
+ * @param job loop
+ * @param index value of the counter
+ * @return true if the body returned to the loop without errors
+ */
+static bool run_iteration(VMState* state, PforJob* job, long long index);
+
+/**
+ * @brief Take the next chunk of the own range or steal half of the largest range of another participant.
+ *
+ * @param worker_id participant id
+ * @param first first index of the chunk
+ * @param last end of the chunk
+ * @return true if there was work left
+ */
+static bool take_chunk(size_t worker_id, long long* first, long long* last);
+
+/**
+ * @brief Execute chunks of the pool job until there is no work left.
+ *
+ * @param worker_id participant id
+ */
+static void run_participant(size_t worker_id);
+
+/**
+ * @brief Wait for pool jobs (thread routine).
+ *
+ * @param worker_ptr PforWorker of the thread
+ * @return void* NULL
+ */
+static void* run_worker(void* worker_ptr);
+
+/**
+ * @brief Start the worker pool with a thread per online processor (the caller being one of them).
+ *
+ * @param registers registers to size states after
+ * @return true if the pool was started
+ */
+static bool start_pool(const MemorySegment* registers);
+
+/**
+ * @brief Stop and free the worker pool.
+ *
+ */
+static void stop_pool();
+
+/**
+ * @brief Wait for the thread taken out of the thread table and free its resources.
+ *
+ * @param thread thread to join
+ * @param thread_id id the thread had
+ * @param err_code variable to use as errno
+ * @return true if the thread finished without errors
+ */
+static bool join_claimed(VMThread* thread, long long thread_id, int* const err_code);
+
+void threads_set_program(const char* content, size_t code_end) {
+    program_content = content;
+    program_code_end = code_end;
+}
+
+int thread_spawn(const char* entry, const MemorySegment* registers, MemorySegment* ram, FrameBuffer* vmd, int* const err_code) {
+    _LOG_FAIL_CHECK_(entry && registers && ram && vmd && program_content, "error", ERROR_REPORTS, return -1, err_code, EFAULT);
+
+    pthread_mutex_lock(&THREADS_MUTEX);
+
+    int thread_id = -1;
+    for (size_t slot = 0; slot < MAX_THREAD_COUNT; ++slot) {
+        if (!THREADS[slot]) {
+            thread_id = (int)slot;
+            break;
+        }
+    }
+
+    _LOG_FAIL_CHECK_(thread_id >= 0, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Can not run more than %lu threads.\n", MAX_THREAD_COUNT);
+        pthread_mutex_unlock(&THREADS_MUTEX);
+        return -1;
+    }, err_code, EAGAIN);
+
+    VMThread* thread = (VMThread*) calloc(1, sizeof(*thread));
+    _LOG_FAIL_CHECK_(thread, "error", ERROR_REPORTS, {
+        pthread_mutex_unlock(&THREADS_MUTEX);
+        return -1;
+    }, err_code, ENOMEM);
+
+    *thread = {};
+    thread->state.pointer = entry;
+    thread->state.ram = ram;
+    thread->state.vmd = vmd;
+
+    bool started = VMState_ctor(&thread->state, registers) &&
+                   pthread_create(&thread->handle, NULL, run_thread, thread) == 0;
+
+    if (started) THREADS[thread_id] = thread;
+    else {
+        VMState_dtor(&thread->state);
+        free(thread);
+    }
+
+    pthread_mutex_unlock(&THREADS_MUTEX);
+
+    _LOG_FAIL_CHECK_(started, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Failed to start a thread.\n");
+        return -1;
+    }, err_code, ENOMEM);
+
+    return thread_id;
+}
+
+bool thread_join(long long thread_id, int* const err_code) {
+    pthread_mutex_lock(&THREADS_MUTEX);
+    VMThread* thread = 0 <= thread_id && (size_t)thread_id < MAX_THREAD_COUNT ? THREADS[thread_id] : NULL;
+    bool valid = thread && !pthread_equal(thread->handle, pthread_self());
+    //* The slot is claimed before joining, so the thread can not be joined twice.
+    if (valid) THREADS[thread_id] = NULL;
+    pthread_mutex_unlock(&THREADS_MUTEX);
+
+    _LOG_FAIL_CHECK_(valid, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "There is no thread %lld to join.\n", thread_id);
+        return false;
+    }, err_code, EINVAL);
+
+    return join_claimed(thread, thread_id, err_code);
+}
+
+bool thread_join_all(bool stop) {
+    if (stop) __atomic_store_n(&stop_requested, true, __ATOMIC_RELAXED);
+
+    bool success = true;
+    //* Running threads can spawn into slots that were already checked, so the search starts over after every join.
+    while (true) {
+        pthread_mutex_lock(&THREADS_MUTEX);
+        size_t thread_id = 0;
+        while (thread_id < MAX_THREAD_COUNT && !THREADS[thread_id]) ++thread_id;
+        VMThread* thread = thread_id < MAX_THREAD_COUNT ? THREADS[thread_id] : NULL;
+        if (thread) THREADS[thread_id] = NULL;
+        pthread_mutex_unlock(&THREADS_MUTEX);
+
+        if (!thread) break;
+
+        success = join_claimed(thread, (long long)thread_id, NULL) && success;
+    }
+
+    stop_pool();
+
+    return success;
+}
+
+bool thread_barrier(long long count, int* const err_code) {
+    _LOG_FAIL_CHECK_(0 < count && (size_t)count <= MAX_THREAD_COUNT + 1, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Barrier can not wait for %lld threads.\n", count);
+        return false;
+    }, err_code, EINVAL);
+
+    pthread_mutex_lock(&BARRIER_MUTEX);
+
+    unsigned long long generation = barrier_generation;
+    if (++barrier_arrived >= count) {
+        barrier_arrived = 0;
+        ++barrier_generation;
+        pthread_cond_broadcast(&BARRIER_COND);
+    } else {
+        while (generation == barrier_generation) pthread_cond_wait(&BARRIER_COND, &BARRIER_MUTEX);
+    }
+
+    pthread_mutex_unlock(&BARRIER_MUTEX);
+
+    return true;
+}
+
+bool thread_parallel_for(const char* loop, const char* body, unsigned char counter, long long begin, long long end,
+                         const MemorySegment* registers, MemorySegment* ram, FrameBuffer* vmd, int* const err_code) {
+    _LOG_FAIL_CHECK_(loop && body && registers && ram && vmd && program_content, "error", ERROR_REPORTS, return false, err_code, EFAULT);
+    _LOG_FAIL_CHECK_(counter < registers->size, "error", ERROR_REPORTS, return false, err_code, EINVAL);
+
+    if (begin >= end) return true;
+
+    PforJob job = {};
+    job.loop = loop;
+    job.body = body;
+    job.counter = counter;
+    job.registers = registers;
+    job.ram = ram;
+    job.vmd = vmd;
+
+    //* Loops started while the pool is busy (nested PFOR or PFOR in several threads) are executed sequentially.
+    bool pooled = pthread_mutex_trylock(&PFOR_BUSY) == 0;
+    if (pooled && !pool && !start_pool(registers)) {
+        pthread_mutex_unlock(&PFOR_BUSY);
+        pooled = false;
+    }
+
+    if (!pooled) {
+        VMState state = {};
+        state.ram = ram;
+        state.vmd = vmd;
+        bool success = VMState_ctor(&state, registers);
+        if (!success && err_code) *err_code = ENOMEM;
+        for (long long index = begin; success && index < end; ++index) {
+            success = run_iteration(&state, &job, index);
+        }
+        if (!success && state.err_code && err_code) *err_code = state.err_code;
+        VMState_dtor(&state);
+        return success;
+    }
+
+    //* The range is split evenly, participants steal from each other when they run out of their parts.
+    long long length = end - begin;
+    for (size_t worker_id = 0; worker_id < pool_size; ++worker_id) {
+        PforWorker* worker = &pool[worker_id];
+        worker->state.ram = ram;
+        worker->state.vmd = vmd;
+        worker->next = begin + length * (long long)worker_id / (long long)pool_size;
+        worker->end  = begin + length * (long long)(worker_id + 1) / (long long)pool_size;
+    }
+
+    pthread_mutex_lock(&POOL_MUTEX);
+    pool_job = job;
+    pool_pending = pool_size - 1;
+    ++pool_generation;
+    pthread_cond_broadcast(&POOL_START);
+    pthread_mutex_unlock(&POOL_MUTEX);
+
+    run_participant(0);
+
+    pthread_mutex_lock(&POOL_MUTEX);
+    while (pool_pending) pthread_cond_wait(&POOL_DONE, &POOL_MUTEX);
+    bool success = !pool_job.failed;
+    if (!success && err_code) *err_code = pool_job.err_code;
+    pthread_mutex_unlock(&POOL_MUTEX);
+
+    pthread_mutex_unlock(&PFOR_BUSY);
+
+    _LOG_FAIL_CHECK_(success, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "PFOR body failed with error %d.\n", pool_job.err_code);
+    }, NULL, 0);
+
+    return success;
+}
+
+static bool VMState_ctor(VMState* state, const MemorySegment* registers) {
+    stack_init(&state->stack, STACK_START_SIZE, &state->err_code);
+    stack_init(&state->addr_stack, ADDR_STACK_START_SIZE, &state->err_code);
+    FrameStack_ctor(&state->frames);
+    state->reg.size = registers->size;
+    MemorySegment_ctor(&state->reg);
+    if (state->reg.content) memcpy(state->reg.content, registers->content, registers->size * sizeof(*registers->content));
+
+    return !state->err_code && state->frames.content && state->reg.content;
+}
+
+static void VMState_dtor(VMState* state) {
+    stack_destroy(&state->stack);
+    stack_destroy(&state->addr_stack);
+    FrameStack_dtor(&state->frames);
+    MemorySegment_dtor(&state->reg);
+}
+
+static void run_state(VMState* state, const char* stop_point) {
+    while (state->pointer != stop_point && !__atomic_load_n(&stop_requested, __ATOMIC_RELAXED)) {
+        int delta = execute_command(program_content, state->pointer, &state->stack, &state->addr_stack, &state->frames,
+                                    state->ram, &state->reg, state->vmd, &state->err_code);
+        if (delta == 0) break;
+
+        const char* next = state->pointer + delta;
+        if (next <= program_content || next >= program_content + program_code_end) {
+            log_printf(ERROR_REPORTS, "error", "Invalid pointer value of 0x%0*lX after executing command at 0x%0*lX in a thread.\n",
+                                               (int)sizeof(uintptr_t), next - program_content,
+                                               (int)sizeof(uintptr_t), state->pointer - program_content);
+            state->err_code = EFAULT;
+            break;
+        }
+
+        state->pointer = next;
+    }
+
+    if (state->err_code) {
+        log_printf(ERROR_REPORTS, "error", "Thread stopped at 0x%0*lX with error %d.\n",
+                                           (int)sizeof(uintptr_t), state->pointer - program_content, state->err_code);
+    }
+}
+
+static void* run_thread(void* thread_ptr) {
+    run_state(&((VMThread*)thread_ptr)->state, NULL);
+    return NULL;
+}
+
+static bool run_iteration(VMState* state, PforJob* job, long long index) {
+    while (state->stack.size) stack_pop(&state->stack);
+    while (state->addr_stack.size) stack_pop(&state->addr_stack);
+    state->frames.size = 0;
+    state->frames.pointer = 0;
+
+    memcpy(state->reg.content, job->registers->content, state->reg.size * sizeof(*state->reg.content));
+    state->reg.content[job->counter] = (int)index;
+
+    //* Body is called like a subroutine that returns to the PFOR command itself.
+    stack_push(&state->addr_stack, (stack_content_t)job->loop, &state->err_code);
+    state->pointer = job->body;
+
+    run_state(state, job->loop);
+
+    _LOG_FAIL_CHECK_(state->err_code || state->pointer == job->loop, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "PFOR body stopped before returning to the loop.\n");
+    }, &state->err_code, EINVAL);
+
+    return state->err_code == 0;
+}
+
+static bool take_chunk(size_t worker_id, long long* first, long long* last) {
+    PforWorker* worker = &pool[worker_id];
+
+    pthread_mutex_lock(&worker->lock);
+    long long remaining = worker->end - worker->next;
+    if (remaining > 0) {
+        long long chunk = (remaining + PFOR_CHUNK_DIVISOR - 1) / PFOR_CHUNK_DIVISOR;
+        *first = worker->next;
+        *last = worker->next + chunk;
+        __atomic_store_n(&worker->next, *last, __ATOMIC_RELAXED);
+    }
+    pthread_mutex_unlock(&worker->lock);
+
+    if (remaining > 0) return true;
+
+    while (true) {
+        size_t victim_id = pool_size;
+        long long largest = 0;
+        for (size_t other_id = 0; other_id < pool_size; ++other_id) {
+            long long other_remaining = __atomic_load_n(&pool[other_id].end, __ATOMIC_RELAXED) -
+                                        __atomic_load_n(&pool[other_id].next, __ATOMIC_RELAXED);
+            if (other_id != worker_id && other_remaining > largest) {
+                largest = other_remaining;
+                victim_id = other_id;
+            }
+        }
+
+        if (victim_id == pool_size) return false;
+
+        //* Thief takes the upper half of the range, its owner keeps taking chunks from the lower end.
+        PforWorker* victim = &pool[victim_id];
+        pthread_mutex_lock(&victim->lock);
+        long long victim_remaining = victim->end - victim->next;
+        long long stolen_first = victim->end - (victim_remaining + 1) / 2;
+        long long stolen_last = victim->end;
+        if (victim_remaining > 0) __atomic_store_n(&victim->end, stolen_first, __ATOMIC_RELAXED);
+        pthread_mutex_unlock(&victim->lock);
+
+        if (victim_remaining <= 0) continue;
+
+        long long stolen = stolen_last - stolen_first;
+        long long chunk = (stolen + PFOR_CHUNK_DIVISOR - 1) / PFOR_CHUNK_DIVISOR;
+
+        pthread_mutex_lock(&worker->lock);
+        __atomic_store_n(&worker->next, stolen_first + chunk, __ATOMIC_RELAXED);
+        __atomic_store_n(&worker->end, stolen_last, __ATOMIC_RELAXED);
+        pthread_mutex_unlock(&worker->lock);
+
+        *first = stolen_first;
+        *last = stolen_first + chunk;
+        return true;
+    }
+}
+
+static void run_participant(size_t worker_id) {
+    PforWorker* worker = &pool[worker_id];
+    long long first = 0, last = 0;
+
+    while (!__atomic_load_n(&pool_job.failed, __ATOMIC_RELAXED) && take_chunk(worker_id, &first, &last)) {
+        for (long long index = first; index < last; ++index) {
+            if (run_iteration(&worker->state, &pool_job, index)) continue;
+
+            pthread_mutex_lock(&POOL_MUTEX);
+            if (!pool_job.failed) pool_job.err_code = worker->state.err_code;
+            __atomic_store_n(&pool_job.failed, true, __ATOMIC_RELAXED);
+            pthread_mutex_unlock(&POOL_MUTEX);
+            return;
+        }
+    }
+}
+
+static void* run_worker(void* worker_ptr) {
+    size_t worker_id = (size_t)((PforWorker*)worker_ptr - pool);
+    unsigned long long generation = 0;
+
+    pthread_mutex_lock(&POOL_MUTEX);
+    while (true) {
+        while (!pool_shutdown && generation == pool_generation) pthread_cond_wait(&POOL_START, &POOL_MUTEX);
+        if (pool_shutdown) break;
+        generation = pool_generation;
+        pthread_mutex_unlock(&POOL_MUTEX);
+
+        run_participant(worker_id);
+
+        pthread_mutex_lock(&POOL_MUTEX);
+        if (--pool_pending == 0) pthread_cond_signal(&POOL_DONE);
+    }
+    pthread_mutex_unlock(&POOL_MUTEX);
+
+    return NULL;
+}
+
+static bool start_pool(const MemorySegment* registers) {
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t size = online > 0 ? (size_t)online : 1;
+    if (size > MAX_PFOR_WORKERS) size = MAX_PFOR_WORKERS;
+
+    pool = (PforWorker*) calloc(size, sizeof(*pool));
+    _LOG_FAIL_CHECK_(pool, "error", ERROR_REPORTS, return false, NULL, 0);
+    pool_shutdown = false;
+
+    bool success = true;
+    for (size_t worker_id = 0; worker_id < size; ++worker_id) {
+        pool[worker_id] = {};
+        success = VMState_ctor(&pool[worker_id].state, registers) && success;
+    }
+
+    //* Workers are started after all states exist, the first participant is the thread executing PFOR.
+    pool_size = 1;
+    for (size_t worker_id = 1; success && worker_id < size; ++worker_id, ++pool_size) {
+        success = pthread_create(&pool[worker_id].handle, NULL, run_worker, &pool[worker_id]) == 0;
+    }
+
+    if (!success) {
+        log_printf(ERROR_REPORTS, "error", "Failed to start PFOR workers, loops will be executed sequentially.\n");
+        for (size_t worker_id = pool_size; worker_id < size; ++worker_id) VMState_dtor(&pool[worker_id].state);
+        stop_pool();
+        return false;
+    }
+
+    log_printf(STATUS_REPORTS, "status", "Started %lu PFOR workers.\n", pool_size);
+
+    return true;
+}
+
+static void stop_pool() {
+    if (!pool) return;
+
+    pthread_mutex_lock(&POOL_MUTEX);
+    pool_shutdown = true;
+    pthread_cond_broadcast(&POOL_START);
+    pthread_mutex_unlock(&POOL_MUTEX);
+
+    for (size_t worker_id = 0; worker_id < pool_size; ++worker_id) {
+        if (worker_id) pthread_join(pool[worker_id].handle, NULL);
+        VMState_dtor(&pool[worker_id].state);
+    }
+
+    free(pool);
+    pool = NULL;
+    pool_size = 0;
+}
+
+static bool join_claimed(VMThread* thread, long long thread_id, int* const err_code) {
+    pthread_join(thread->handle, NULL);
+
+    int status = thread->state.err_code;
+
+    VMState_dtor(&thread->state);
+    free(thread);
+
+    _LOG_FAIL_CHECK_(status == 0, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Thread %lld failed with error %d.\n", thread_id, status);
+        return false;
+    }, err_code, status);
+
+    return true;
+}
@@ -0,0 +1,91 @@
+/**
+ * @file vm_threads.h
+ * @author Kudryashov Ilya (kudriashov.it@phystech.edu)
+ * @brief Processor threads started by SPAWN.
+ * @version 0.1
+ * @date 2022-11-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef VM_THREADS_H
+#define VM_THREADS_H
+
+#ifndef PROCESSOR
+    #error vm_threads.h should only be included by the processor after its config.h.
+#endif
+
+#include <stdlib.h>
+
+#include "src/config.h"
+
+#include "common.h"
+
+/**
+ * @brief Set the program threads will execute.
+ *
+ * @param content program image
+ * @param code_end end of the program code
+ */
+void threads_set_program(const char* content, size_t code_end);
+
+/**
+ * @brief Start new processor thread with its own stacks, frames and a copy of the registers.
+ *
+ * @param entry first command of the thread
+ * @param registers registers to copy
+ * @param ram RAM shared with the thread
+ * @param vmd video memory shared with the thread
+ * @param err_code variable to use as errno
+ * @return int thread id (-1 if the thread was not started)
+ */
+int thread_spawn(const char* entry, const MemorySegment* registers, MemorySegment* ram, FrameBuffer* vmd, int* const err_code = NULL);
+
+/**
+ * @brief Wait for the thread to finish and free its resources.
+ *
+ * @param thread_id id returned by thread_spawn()
+ * @param err_code variable to use as errno
+ * @return true if the thread finished without errors
+ */
+bool thread_join(long long thread_id, int* const err_code = NULL);
+
+/**
+ * @brief Wait for all threads that were not joined and stop the PFOR worker pool.
+ *
+ * @param stop ask the threads to stop before their END
+ * @return true if all of them finished without errors
+ */
+bool thread_join_all(bool stop);
+
+/**
+ * @brief Wait until the given number of threads reaches the barrier.
+ *
+ * @param count number of threads to wait for (including the calling one)
+ * @param err_code variable to use as errno
+ * @return true if the count was valid
+ */
+bool thread_barrier(long long count, int* const err_code = NULL);
+
+/**
+ * @brief Execute the body for every index of the range on the worker pool and wait for all of them.
+ *
+ * Every iteration starts with its own empty stacks and a copy of the registers with the counter set to the index,
+ * the body returns to the loop command with RET.
+ *
+ * @param loop PFOR command
+ * @param body first command of the body
+ * @param counter register receiving the index
+ * @param begin first index
+ * @param end index after the last one
+ * @param registers registers of the thread executing PFOR
+ * @param ram shared RAM
+ * @param vmd shared video memory
+ * @param err_code variable to use as errno
+ * @return true if all iterations succeeded
+ */
+bool thread_parallel_for(const char* loop, const char* body, unsigned char counter, long long begin, long long end,
+                         const MemorySegment* registers, MemorySegment* ram, FrameBuffer* vmd, int* const err_code = NULL);
+
+#endif